@@ -0,0 +1,530 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "allocator.hpp"
+#include "build_config.hpp"
+#include "math.hpp"
+#include "shader.hpp"
+#include "shader_archive.hpp"
+#include "transforms.hpp"
+
+// CPU-only microbenchmarks. None of them create a Vulkan device, so they run anywhere.
+// Usage: benchmarks [suite...]   (no suite runs all of them)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// run() returns false if a kernel's results disagree with its reference implementation.
+class Suite {
+   public:
+    std::string           name;
+    std::function<bool()> run;
+};
+
+double elapsed_ns(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+/* ---- Allocator ---- */
+
+constexpr uint32_t ALLOCATOR_RESOURCE_COUNT = 10000;
+constexpr uint32_t ALLOCATOR_MEMORY_TYPES   = 2;
+
+VkPhysicalDeviceMemoryProperties mock_memory_properties() {
+    VkPhysicalDeviceMemoryProperties memory_properties{};
+    memory_properties.memoryTypeCount              = ALLOCATOR_MEMORY_TYPES;
+    memory_properties.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    memory_properties.memoryTypes[1].propertyFlags =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    return memory_properties;
+}
+
+// Buffer-like requests between 256 B and 512 KiB, the range that makes one allocation per resource hurt.
+std::vector<VkMemoryRequirements> make_memory_requirements(uint32_t count) {
+    std::mt19937                            rng(42);
+    std::uniform_int_distribution<uint32_t> size_shift(8, 18);
+    std::uniform_int_distribution<uint32_t> alignment_shift(4, 8);
+
+    std::vector<VkMemoryRequirements> requirements(count);
+    for (VkMemoryRequirements& requirement : requirements) {
+        VkDeviceSize base = VkDeviceSize{1} << size_shift(rng);
+
+        requirement.size           = base + rng() % base;
+        requirement.alignment      = VkDeviceSize{1} << alignment_shift(rng);
+        requirement.memoryTypeBits = 1u;
+    }
+
+    return requirements;
+}
+
+void print_allocator_row(const std::string& label, double alloc_ns, double free_ns, uint64_t backend_calls,
+                         uint32_t failed) {
+    std::cout << "  " << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << alloc_ns << " ns/alloc" << std::setw(10) << free_ns << " ns/free"
+              << std::setw(8) << backend_calls << " backend allocations" << std::setw(7) << failed << " failed\n";
+}
+
+// Baseline: what the renderer used to do, one backend allocation per resource.
+void bench_allocator_dedicated(const std::vector<VkMemoryRequirements>& requirements) {
+    renderer::MockMemoryBackend backend;
+
+    std::vector<VkDeviceMemory> memories;
+    memories.reserve(requirements.size());
+    uint32_t failed = 0;
+
+    auto alloc_start = Clock::now();
+    for (const VkMemoryRequirements& requirement : requirements) {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        if (backend.allocate(0, requirement.size, &memory) == VK_SUCCESS) {
+            memories.push_back(memory);
+        } else {
+            ++failed;
+        }
+    }
+    auto alloc_end = Clock::now();
+
+    for (VkDeviceMemory memory : memories) {
+        backend.free(memory);
+    }
+    auto free_end = Clock::now();
+
+    print_allocator_row("vkAllocateMemory each", elapsed_ns(alloc_start, alloc_end) / requirements.size(),
+                        elapsed_ns(alloc_end, free_end) / std::max<size_t>(memories.size(), 1),
+                        backend.allocate_calls, failed);
+}
+
+void bench_allocator_pooled(const std::vector<VkMemoryRequirements>& requirements,
+                            renderer::AllocationStrategy strategy, const std::string& label) {
+    renderer::MockMemoryBackend backend;
+    renderer::DeviceAllocator   allocator;
+    allocator.init(backend, mock_memory_properties(), 1024);
+
+    std::vector<renderer::Allocation> allocations;
+    allocations.reserve(requirements.size());
+
+    auto alloc_start = Clock::now();
+    for (const VkMemoryRequirements& requirement : requirements) {
+        allocations.push_back(allocator.allocate(requirement, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, strategy));
+    }
+    auto alloc_end = Clock::now();
+
+    renderer::AllocatorStats stats = allocator.stats();
+
+    for (renderer::Allocation& allocation : allocations) {
+        allocator.free(allocation);
+    }
+    auto free_end = Clock::now();
+
+    print_allocator_row(label, elapsed_ns(alloc_start, alloc_end) / requirements.size(),
+                        elapsed_ns(alloc_end, free_end) / requirements.size(), backend.allocate_calls, 0);
+
+    std::cout << "    " << stats.block_count << " blocks, " << stats.bytes_reserved / (1024 * 1024) << " MiB reserved, "
+              << std::setprecision(1) << 100.0 * stats.bytes_requested / stats.bytes_reserved << "% of it requested\n";
+
+    allocator.cleanup();
+}
+
+// Frees every other allocation and reports how scattered the remaining free space is.
+void bench_allocator_fragmentation(const std::vector<VkMemoryRequirements>& requirements) {
+    renderer::MockMemoryBackend backend;
+    renderer::DeviceAllocator   allocator;
+    allocator.init(backend, mock_memory_properties(), 1024);
+
+    std::vector<renderer::Allocation> allocations;
+    for (const VkMemoryRequirements& requirement : requirements) {
+        allocations.push_back(allocator.allocate(requirement, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+    }
+
+    for (size_t i = 0; i < allocations.size(); i += 2) {
+        allocator.free(allocations[i]);
+    }
+
+    renderer::AllocatorStats stats = allocator.stats();
+    std::cout << "  buddy after freeing half: " << stats.allocation_count << " live, fragmentation "
+              << std::setprecision(3) << stats.fragmentation << "\n";
+
+    allocator.cleanup();
+}
+
+bool run_allocator_suite() {
+    auto requirements = make_memory_requirements(ALLOCATOR_RESOURCE_COUNT);
+
+    std::cout << "allocator: " << ALLOCATOR_RESOURCE_COUNT << " resources, mock backend limited to 4096 allocations\n";
+    bench_allocator_dedicated(requirements);
+    bench_allocator_pooled(requirements, renderer::AllocationStrategy::Buddy, "DeviceAllocator buddy");
+    bench_allocator_pooled(requirements, renderer::AllocationStrategy::Linear, "DeviceAllocator linear");
+    bench_allocator_fragmentation(requirements);
+
+    return true;
+}
+
+/* ---- Math ---- */
+
+constexpr uint32_t MATH_BATCH_SIZE = 4096;  // 64 KiB of vec4s or 256 KiB of mat4s per batch
+constexpr uint32_t MATH_PASSES     = 500;
+constexpr float    MATH_TOLERANCE  = 1e-5f;  // inputs are in [-1, 1], FMA and summation order differ by a few ulp
+
+math::Mat4 random_mat4(std::mt19937& rng) {
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+    math::Mat4 m;
+    for (math::Vec4& column : m.columns) {
+        column = {value(rng), value(rng), value(rng), value(rng)};
+    }
+    return m;
+}
+
+float max_difference(std::span<const float> a, std::span<const float> b) {
+    float difference = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i) {
+        difference = std::max(difference, std::abs(a[i] - b[i]));
+    }
+    return difference;
+}
+
+// Runs kernel MATH_PASSES times over a batch and returns the time per element.
+template <class Kernel>
+double time_math_kernel(Kernel kernel) {
+    kernel();  // warm up caches and page in the outputs
+
+    auto start = Clock::now();
+    for (uint32_t pass = 0; pass < MATH_PASSES; ++pass) {
+        kernel();
+    }
+    auto end = Clock::now();
+
+    return elapsed_ns(start, end) / (double{MATH_PASSES} * MATH_BATCH_SIZE);
+}
+
+// Times the scalar and SIMD version of one kernel and checks that both produced the same results.
+template <class ScalarKernel, class SimdKernel>
+bool compare_math_kernels(const std::string& label, ScalarKernel scalar_kernel, SimdKernel simd_kernel,
+                          std::span<const float> scalar_out, std::span<const float> simd_out) {
+    double scalar_ns  = time_math_kernel(scalar_kernel);
+    double simd_ns    = time_math_kernel(simd_kernel);
+    float  difference = max_difference(scalar_out, simd_out);
+    bool   matches    = difference <= MATH_TOLERANCE;
+
+    std::cout << "  " << std::left << std::setw(14) << label << std::right << std::fixed << std::setprecision(2)
+              << " scalar" << std::setw(8) << scalar_ns << " ns/op, simd" << std::setw(8) << simd_ns
+              << " ns/op, speedup " << scalar_ns / simd_ns << "x, max difference " << std::scientific << difference
+              << std::fixed << (matches ? "" : ", MISMATCH") << "\n";
+
+    return matches;
+}
+
+bool run_math_suite() {
+    std::mt19937 rng(42);
+
+    math::Mat4              m = random_mat4(rng);
+    std::vector<math::Vec4> points(MATH_BATCH_SIZE);
+    std::vector<math::Mat4> a(MATH_BATCH_SIZE);
+    std::vector<math::Mat4> b(MATH_BATCH_SIZE);
+    for (uint32_t i = 0; i < MATH_BATCH_SIZE; ++i) {
+        points[i] = random_mat4(rng).columns[0];
+        a[i]      = random_mat4(rng);
+        b[i]      = random_mat4(rng);
+    }
+
+    std::vector<math::Vec4> scalar_points(MATH_BATCH_SIZE);
+    std::vector<math::Vec4> simd_points(MATH_BATCH_SIZE);
+    std::vector<math::Mat4> scalar_matrices(MATH_BATCH_SIZE);
+    std::vector<math::Mat4> simd_matrices(MATH_BATCH_SIZE);
+
+    auto point_floats = [](const std::vector<math::Vec4>& values) {
+        return std::span<const float>(&values.data()->x, values.size() * 4);
+    };
+    auto matrix_floats = [](const std::vector<math::Mat4>& values) {
+        return std::span<const float>(&values.data()->columns[0].x, values.size() * 16);
+    };
+
+    std::cout << "math: batches of " << MATH_BATCH_SIZE << ", SIMD path: " << math::simd_path() << "\n";
+
+    bool matches = compare_math_kernels(
+        "mat4 * vec4", [&] { math::scalar::transform(m, points, scalar_points); },
+        [&] { math::transform(m, points, simd_points); }, point_floats(scalar_points), point_floats(simd_points));
+    matches &= compare_math_kernels(
+        "mat4 * mat4", [&] { math::scalar::multiply(a, b, scalar_matrices); },
+        [&] { math::multiply(a, b, simd_matrices); }, matrix_floats(scalar_matrices), matrix_floats(simd_matrices));
+    matches &= compare_math_kernels(
+        "parent * mat4", [&] { math::scalar::multiply(m, b, scalar_matrices); },
+        [&] { math::multiply(m, b, simd_matrices); }, matrix_floats(scalar_matrices), matrix_floats(simd_matrices));
+
+    return matches;
+}
+
+/* ---- Transforms ---- */
+
+constexpr uint32_t TRANSFORM_COUNTS[]        = {10000, 100000, 1000000};
+constexpr uint64_t TRANSFORM_WORK_PER_COUNT  = 20000000;  // instances per measurement, split into passes
+constexpr uint32_t TRANSFORM_INSTANCE_MEMORY = 1;         // host-visible type of mock_memory_properties()
+constexpr float    TRANSFORM_TOLERANCE       = 1e-4f;     // translations reach 100, a few ulp there is ~1e-5
+
+math::Transform random_transform(std::mt19937& rng) {
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+    math::Transform transform;
+    transform.position = {100.0f * value(rng), 100.0f * value(rng), 100.0f * value(rng)};
+    transform.rotation = math::axis_angle(math::normalize(math::Vec3{value(rng), value(rng), value(rng)}), value(rng));
+    transform.scale    = {scale(rng), scale(rng), scale(rng)};
+    return transform;
+}
+
+// Runs kernel over count instances until TRANSFORM_WORK_PER_COUNT instances were processed, returns ns per instance.
+template <class Kernel>
+double time_transform_kernel(uint32_t count, Kernel kernel) {
+    const uint64_t passes = std::max<uint64_t>(TRANSFORM_WORK_PER_COUNT / count, 1);
+
+    kernel();
+
+    auto start = Clock::now();
+    for (uint64_t pass = 0; pass < passes; ++pass) {
+        kernel();
+    }
+    auto end = Clock::now();
+
+    return elapsed_ns(start, end) / (double(passes) * count);
+}
+
+// World matrices are written straight into a persistently mapped instance buffer, as the renderer does.
+bool bench_transforms(uint32_t count) {
+    std::mt19937 rng(42);
+
+    std::vector<math::Transform> aos(count);
+    math::TransformSoA           soa;
+    soa.reserve(count);
+    for (math::Transform& transform : aos) {
+        transform = random_transform(rng);
+        soa.push_back(transform);
+    }
+
+    renderer::MockMemoryBackend backend;
+    renderer::DeviceAllocator   allocator;
+    allocator.init(backend, mock_memory_properties(), 1024);
+
+    VkMemoryRequirements requirements{};
+    requirements.size           = VkDeviceSize{count} * sizeof(math::Mat4);
+    requirements.alignment      = alignof(math::Mat4);
+    requirements.memoryTypeBits = 1u << TRANSFORM_INSTANCE_MEMORY;
+
+    renderer::Allocation instances = allocator.allocate(
+        requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    std::span<math::Mat4> mapped(static_cast<math::Mat4*>(instances.mapped), count);
+    std::vector<math::Mat4> reference(count);
+
+    double aos_ns = time_transform_kernel(count, [&] { math::compute_world_matrices(aos, mapped); });
+    double soa_scalar_ns =
+        time_transform_kernel(count, [&] { math::scalar::compute_world_matrices(soa, 0, mapped); });
+    std::copy(mapped.begin(), mapped.end(), reference.begin());
+    double soa_simd_ns = time_transform_kernel(count, [&] { math::compute_world_matrices(soa, 0, mapped); });
+
+    float difference = max_difference(std::span<const float>(&reference.data()->columns[0].x, count * 16),
+                                      std::span<const float>(&mapped.data()->columns[0].x, count * 16));
+    bool  matches    = difference <= TRANSFORM_TOLERANCE;
+
+    std::cout << "  " << std::setw(8) << count << " instances:" << std::fixed << std::setprecision(2)
+              << " aos" << std::setw(7) << aos_ns << " ns, soa scalar" << std::setw(7) << soa_scalar_ns
+              << " ns, soa simd" << std::setw(7) << soa_simd_ns << " ns, speedup over aos " << aos_ns / soa_simd_ns
+              << "x, max difference " << std::scientific << difference << std::fixed
+              << (matches ? "" : ", MISMATCH") << "\n";
+
+    allocator.free(instances);
+    allocator.cleanup();
+
+    return matches;
+}
+
+bool run_transforms_suite() {
+    std::cout << "transforms: world matrix update into mapped memory, SIMD path: " << math::simd_path() << "\n";
+
+    bool matches = true;
+    for (uint32_t count : TRANSFORM_COUNTS) {
+        matches &= bench_transforms(count);
+    }
+
+    return matches;
+}
+
+/* ---- Shaders ---- */
+
+constexpr uint32_t SHADER_COUNT     = 500;
+constexpr uint32_t SHADER_MIN_WORDS = 1024;   // 4 KiB
+constexpr uint32_t SHADER_MAX_WORDS = 16384;  // 64 KiB, the size of a large uber-shader variant
+constexpr uint32_t SHADER_PASSES    = 5;
+
+// What vkCreateShaderModule does with the code at the least: read every word.
+uint32_t checksum(std::span<const uint32_t> code) {
+    uint32_t sum = 0;
+    for (uint32_t word : code) {
+        sum += word;
+    }
+    return sum;
+}
+
+// SHADER_COUNT files with a valid SPIR-V header and random payload, written to a scratch directory.
+std::vector<std::string> write_shader_files(const std::filesystem::path& directory) {
+    std::mt19937                            rng(42);
+    std::uniform_int_distribution<uint32_t> word_count(SHADER_MIN_WORDS, SHADER_MAX_WORDS);
+
+    std::filesystem::create_directories(directory);
+
+    std::vector<std::string> paths;
+    for (uint32_t i = 0; i < SHADER_COUNT; ++i) {
+        std::vector<uint32_t> words(word_count(rng));
+        for (uint32_t& word : words) {
+            word = rng();
+        }
+        words[0] = renderer::ShaderBlob::SPIRV_MAGIC;
+
+        paths.push_back((directory / ("shader_" + std::to_string(i) + ".spv")).string());
+        std::ofstream file(paths.back(), std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size() * 4));
+    }
+
+    return paths;
+}
+
+// The loader ShaderBlob replaced: size the file, copy it into a heap buffer and reinterpret it.
+uint32_t load_with_ifstream(const std::string& path) {
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+
+    std::vector<char> buffer(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+    return checksum({reinterpret_cast<const uint32_t*>(buffer.data()), buffer.size() / 4});
+}
+
+uint32_t load_with_mmap(const std::string& path) {
+    renderer::ShaderBlob blob = renderer::ShaderBlob::map_file(path);
+    return checksum(blob.code());
+}
+
+// Best of SHADER_PASSES passes over every file, in ms. Files stay in the page cache after the first pass, so this
+// measures the loader itself rather than the disk.
+template <class Load>
+double time_shader_loads(const std::vector<std::string>& paths, Load load, uint32_t& sum) {
+    double best_ms = 0.0;
+    for (uint32_t pass = 0; pass < SHADER_PASSES; ++pass) {
+        auto start = Clock::now();
+        for (const std::string& path : paths) {
+            sum += load(path);
+        }
+        auto end = Clock::now();
+
+        double pass_ms = elapsed_ns(start, end) / 1e6;
+        best_ms        = pass == 0 ? pass_ms : std::min(best_ms, pass_ms);
+    }
+
+    return best_ms;
+}
+
+bool run_shaders_suite() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "renderer_shader_bench";
+
+    std::vector<std::string> paths = write_shader_files(directory);
+
+    uintmax_t total_bytes = 0;
+    for (const std::string& path : paths) {
+        total_bytes += std::filesystem::file_size(path);
+    }
+
+    std::cout << "shaders: loading " << SHADER_COUNT << " SPIR-V files, " << total_bytes / 1024
+              << " KiB in total, page cache warm\n";
+
+    // The archive is mapped once, outside the timed passes, as apps do at startup.
+    const std::string archive_path = (directory / "shaders.pak").string();
+    renderer::ShaderArchive::write(archive_path, paths);
+
+    renderer::ShaderArchive archive{};
+
+    auto open_start = Clock::now();
+    archive.init(archive_path);
+    auto open_end = Clock::now();
+
+    auto load_from_archive = [&archive](const std::string& path) { return checksum(archive.load(path).code()); };
+
+    uint32_t ifstream_sum = 0;
+    uint32_t mmap_sum     = 0;
+    uint32_t archive_sum  = 0;
+    double   ifstream_ms  = time_shader_loads(paths, load_with_ifstream, ifstream_sum);
+    double   mmap_ms      = time_shader_loads(paths, load_with_mmap, mmap_sum);
+    double   archive_ms   = time_shader_loads(paths, load_from_archive, archive_sum);
+
+    std::cout << std::fixed << std::setprecision(2) << "  ifstream + heap copy " << std::setw(8) << ifstream_ms
+              << " ms, " << ifstream_ms * 1000.0 / SHADER_COUNT << " us/shader\n"
+              << "  mmap ShaderBlob      " << std::setw(8) << mmap_ms << " ms, " << mmap_ms * 1000.0 / SHADER_COUNT
+              << " us/shader, speedup " << ifstream_ms / mmap_ms << "x"
+              << (ifstream_sum == mmap_sum ? "" : ", CHECKSUM MISMATCH") << "\n"
+              << "  packed archive       " << std::setw(8) << archive_ms << " ms, "
+              << archive_ms * 1000.0 / SHADER_COUNT << " us/shader, speedup " << ifstream_ms / archive_ms << "x"
+              << (ifstream_sum == archive_sum ? "" : ", CHECKSUM MISMATCH") << " (+ "
+              << elapsed_ns(open_start, open_end) / 1e6 << " ms to map it once)\n";
+
+    archive.cleanup();
+
+    std::filesystem::remove_all(directory);
+
+    return ifstream_sum == mmap_sum && ifstream_sum == archive_sum;
+}
+
+const std::vector<Suite>& suites() {
+    static const std::vector<Suite> suites = {
+        {"allocator", run_allocator_suite},
+        {"math", run_math_suite},
+        {"shaders", run_shaders_suite},
+        {"transforms", run_transforms_suite},
+    };
+
+    return suites;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> selected(argv + 1, argv + argc);
+
+    for (const std::string& name : selected) {
+        if (std::none_of(suites().begin(), suites().end(), [&](const Suite& suite) { return suite.name == name; })) {
+            std::cerr << "unknown benchmark suite: " << name << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << "benchmarks: " << renderer::BUILD_CONFIG_NAME << " build\n";
+
+    bool matches = true;
+    try {
+        for (const Suite& suite : suites()) {
+            if (selected.empty() || std::find(selected.begin(), selected.end(), suite.name) != selected.end()) {
+                matches &= suite.run();
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!matches) {
+        std::cerr << "benchmarks => results differ from their reference implementation, see MISMATCH above\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace renderer {
+
+/* ---- Memory backends ---- */
+
+// The only place the allocator talks to the driver. Swapping in MockMemoryBackend lets the allocator be
+// exercised and benchmarked on machines without a GPU.
+class MemoryBackend {
+   public:
+    virtual ~MemoryBackend() = default;
+
+    virtual VkResult allocate(uint32_t memory_type, VkDeviceSize size, VkDeviceMemory* memory) = 0;
+    virtual void     free(VkDeviceMemory memory)                                              = 0;
+    virtual VkResult map(VkDeviceMemory memory, VkDeviceSize size, void** data)               = 0;
+};
+
+class VulkanMemoryBackend : public MemoryBackend {
+   private:
+    VkDevice m_device = VK_NULL_HANDLE;
+
+   public:
+    explicit VulkanMemoryBackend(VkDevice device) : m_device(device) {}
+
+    VkResult allocate(uint32_t memory_type, VkDeviceSize size, VkDeviceMemory* memory) override;
+    void     free(VkDeviceMemory memory) override;
+    VkResult map(VkDeviceMemory memory, VkDeviceSize size, void** data) override;
+};
+
+// Pure CPU stand-in for vkAllocateMemory: hands out fake handles backed by host memory and enforces
+// maxMemoryAllocationCount like a driver would.
+class MockMemoryBackend : public MemoryBackend {
+   private:
+    uint32_t m_max_allocation_count = 4096;
+    uint64_t m_next_handle          = 1;
+
+    std::unordered_map<VkDeviceMemory, std::unique_ptr<std::byte[]>> m_allocations;
+
+   public:
+    uint64_t allocate_calls = 0;
+    uint64_t free_calls     = 0;
+
+    explicit MockMemoryBackend(uint32_t max_allocation_count = 4096) : m_max_allocation_count(max_allocation_count) {}
+
+    VkResult allocate(uint32_t memory_type, VkDeviceSize size, VkDeviceMemory* memory) override;
+    void     free(VkDeviceMemory memory) override;
+    VkResult map(VkDeviceMemory memory, VkDeviceSize size, void** data) override;
+
+    uint32_t live_allocation_count() const { return static_cast<uint32_t>(m_allocations.size()); }
+};
+
+/* ---- Offset allocators ---- */
+
+// Power-of-two buddy allocator over [0, min_size << max_order). Every node is aligned to its own size, so
+// rounding a request up to max(size, alignment) satisfies any power-of-two alignment.
+class BuddyAllocator {
+   private:
+    VkDeviceSize m_min_size  = 0;
+    uint32_t     m_max_order = 0;
+    VkDeviceSize m_used      = 0;
+
+    std::vector<std::unordered_set<VkDeviceSize>> m_free_lists;
+
+   public:
+    void init(VkDeviceSize min_size, uint32_t max_order);
+
+    uint32_t                    order_for(VkDeviceSize size, VkDeviceSize alignment) const;
+    std::optional<VkDeviceSize> allocate(uint32_t order);
+    void                        free(VkDeviceSize offset, uint32_t order);
+
+    VkDeviceSize size() const { return m_min_size << m_max_order; }
+    VkDeviceSize node_size(uint32_t order) const { return m_min_size << order; }
+    VkDeviceSize used() const { return m_used; }
+    VkDeviceSize largest_free() const;
+    bool         empty() const { return m_used == 0; }
+};
+
+// Bump allocator. Individual frees only count down; the whole range is reclaimed once nothing is live,
+// which suits transient and per-frame resources that die together.
+class LinearAllocator {
+   private:
+    VkDeviceSize m_size       = 0;
+    VkDeviceSize m_head       = 0;
+    VkDeviceSize m_used       = 0;
+    uint32_t     m_live_count = 0;
+
+   public:
+    void init(VkDeviceSize size);
+
+    std::optional<VkDeviceSize> allocate(VkDeviceSize size, VkDeviceSize alignment);
+    void                        free(VkDeviceSize size);
+
+    VkDeviceSize size() const { return m_size; }
+    VkDeviceSize used() const { return m_used; }
+    VkDeviceSize largest_free() const { return m_size - m_head; }
+    bool         empty() const { return m_live_count == 0; }
+};
+
+/* ---- Device allocator ---- */
+
+enum class AllocationStrategy { Buddy, Linear };
+
+class Allocation {
+   public:
+    static constexpr uint32_t DEDICATED = std::numeric_limits<uint32_t>::max();
+
+    VkDeviceMemory     memory      = VK_NULL_HANDLE;
+    VkDeviceSize       offset      = 0;
+    VkDeviceSize       size        = 0;
+    void*              mapped      = nullptr;
+    uint32_t           memory_type = 0;
+    uint32_t           block_index = DEDICATED;
+    uint32_t           order       = 0;
+    AllocationStrategy strategy    = AllocationStrategy::Buddy;
+};
+
+class AllocatorStats {
+   public:
+    VkDeviceSize bytes_reserved   = 0;  // device memory held by blocks and dedicated allocations
+    VkDeviceSize bytes_used       = 0;  // bytes handed out, including buddy rounding
+    VkDeviceSize bytes_requested  = 0;  // bytes asked for
+    uint32_t     block_count      = 0;
+    uint32_t     dedicated_count  = 0;
+    uint32_t     allocation_count = 0;
+
+    // 1 - largest free range / total free bytes, 0 when all free memory is one contiguous range.
+    double fragmentation = 0.0;
+};
+
+// Reserves large blocks per memory type and sub-allocates from them, so thousands of resources share a
+// handful of vkAllocateMemory calls. Requests larger than half a block get a dedicated allocation.
+// HOST_VISIBLE blocks are persistently mapped. Thread-safe.
+class DeviceAllocator {
+   private:
+    static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64 * 1024 * 1024;
+    static constexpr VkDeviceSize MIN_NODE_SIZE      = 256;
+
+    class MemoryBlock {
+       public:
+        VkDeviceMemory     memory      = VK_NULL_HANDLE;
+        uint32_t           memory_type = 0;
+        AllocationStrategy strategy    = AllocationStrategy::Buddy;
+        std::byte*         mapped      = nullptr;
+        BuddyAllocator     buddy       = {};
+        LinearAllocator    linear      = {};
+
+        VkDeviceSize size() const { return strategy == AllocationStrategy::Buddy ? buddy.size() : linear.size(); }
+        VkDeviceSize used() const { return strategy == AllocationStrategy::Buddy ? buddy.used() : linear.used(); }
+        bool         empty() const { return strategy == AllocationStrategy::Buddy ? buddy.empty() : linear.empty(); }
+        VkDeviceSize largest_free() const {
+            return strategy == AllocationStrategy::Buddy ? buddy.largest_free() : linear.largest_free();
+        }
+    };
+
+    MemoryBackend*                   m_backend           = nullptr;
+    VkPhysicalDeviceMemoryProperties m_memory_properties = {};
+    VkDeviceSize                     m_block_size        = DEFAULT_BLOCK_SIZE;
+    VkDeviceSize                     m_granularity       = 1;
+
+    std::vector<std::unique_ptr<MemoryBlock>> m_blocks;
+    std::vector<Allocation>                   m_dedicated;
+    VkDeviceSize                              m_bytes_requested  = 0;
+    uint32_t                                  m_allocation_count = 0;
+
+    mutable std::mutex m_mutex;
+
+   public:
+    // buffer_image_granularity is VkPhysicalDeviceLimits::bufferImageGranularity; every sub-allocation is
+    // aligned to it so linear and optimal resources can share a block.
+    void init(MemoryBackend& backend, const VkPhysicalDeviceMemoryProperties& memory_properties,
+              VkDeviceSize buffer_image_granularity = 1, VkDeviceSize block_size = DEFAULT_BLOCK_SIZE);
+    void cleanup();
+
+    Allocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+                        AllocationStrategy strategy = AllocationStrategy::Buddy);
+    void       free(Allocation& allocation);
+
+    // Returns empty blocks to the backend.
+    void trim();
+
+    uint32_t       find_memory_type(uint32_t type_filter, VkMemoryPropertyFlags properties) const;
+    AllocatorStats stats() const;
+
+   private:
+    Allocation   allocate_dedicated(uint32_t memory_type, VkDeviceSize size);
+    MemoryBlock& create_block(uint32_t memory_type, AllocationStrategy strategy, uint32_t& block_index);
+    bool         try_allocate_from(MemoryBlock& block, VkDeviceSize size, VkDeviceSize alignment,
+                                   Allocation& allocation);
+    void*        map_if_host_visible(uint32_t memory_type, VkDeviceMemory memory, VkDeviceSize size);
+};
+
+}  // namespace renderer
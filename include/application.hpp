@@ -0,0 +1,212 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bindless_table.hpp"
+#include "buffer.hpp"
+#include "device_context.hpp"
+#include "frame_ring_buffer.hpp"
+#include "frame_scheduler.hpp"
+#include "frame_tracer.hpp"
+#include "gpu_profiler.hpp"
+#include "job_system.hpp"
+#include "parallel_recorder.hpp"
+#include "pipeline_cache.hpp"
+#include "pipeline_compiler.hpp"
+#include "pipeline_state_cache.hpp"
+#include "shader_archive.hpp"
+#include "shader_watcher.hpp"
+#include "swapchain.hpp"
+#include "upload_scheduler.hpp"
+
+namespace renderer {
+
+// Where the --stream-mb benchmark submits its uploads.
+enum class UploadQueueMode {
+    Transfer,  // UploadScheduler on the dedicated transfer queue, if the device has one
+    Graphics,  // UploadScheduler on the graphics queue
+    Blocking,  // UploadContext, waiting for every copy on the host
+};
+
+class ApplicationOptions {
+   public:
+    bool     headless         = false;
+    uint32_t benchmark_frames = 1000;
+    uint32_t draw_count       = 1;
+    uint32_t record_threads   = 1;
+    bool     record_sweep     = false;
+    uint32_t instance_count   = 0;
+    bool     instance_sweep   = false;
+    bool     gpu_culling      = false;
+    bool     bindless         = false;
+    uint32_t stream_mb        = 0;
+    uint32_t pipeline_threads = 0;
+    bool     render_pass      = false;  // use the VkRenderPass path even where dynamic rendering is available
+    bool     hot_reload       = false;  // recompile edited shaders and rebuild their pipelines while running
+
+    CommandPoolStrategy command_pool_strategy = CommandPoolStrategy::PerFramePool;
+    FrameSyncMode       frame_sync_mode       = FrameSyncMode::Timeline;
+    UploadQueueMode     upload_queue          = UploadQueueMode::Transfer;
+    std::string         gpu_trace_path        = {};
+    std::string         cpu_trace_path        = {};
+};
+
+// Usage: <app> [--headless] [--frames <count>] [--draws <count>] [--threads <count>] [--record-sweep]
+//              [--instances <count>] [--instance-sweep] [--gpu-cull] [--bindless]
+//              [--stream-mb <count>] [--upload-queue transfer|graphics|blocking] [--pipeline-threads <count>]
+//              [--render-pass] [--hot-reload]
+//              [--command-pool-reset pool|buffer] [--sync fence|timeline]
+//              [--gpu-trace <file.csv|file.json>] [--cpu-trace <file.json>]
+ApplicationOptions parse_options(int argc, char** argv);
+
+class FrameTimings {
+   public:
+    std::vector<double> cpu_ms;
+    std::vector<double> record_ms;
+    std::vector<double> gpu_ms;
+};
+
+// Window, device, swapchain and frame loop shared by all apps. An app only provides its scene:
+// the resources it creates once the device exists and the commands it records inside the render pass.
+class Application {
+   private:
+    static constexpr uint32_t WINDOW_WIDTH  = 800;
+    static constexpr uint32_t WINDOW_HEIGHT = 600;
+
+    // Relative to the executable in bin/<config>/, wherever the app is started from. The cache and the archive are
+    // per configuration, compiled SPIR-V in bin/shaders/ is shared.
+    static constexpr const char* PIPELINE_CACHE_DIRECTORY = "cache";
+    static constexpr const char* SHADER_ARCHIVE_NAME      = "shaders.pak";
+    static constexpr const char* SHADER_SOURCE_DIRECTORY  = "../../shaders";  // watched with --hot-reload
+    static constexpr const char* SHADER_OUTPUT_DIRECTORY  = "../shaders";
+
+    std::string m_name = {};
+
+    GLFWwindow*                m_window                 = nullptr;
+    bool                       m_dynamic_rendering      = false;  // no render pass or framebuffers to rebuild
+    std::vector<VkFramebuffer> m_swapchain_framebuffers = {};     // render pass path only
+    FrameScheduler             m_frame_scheduler        = {};
+    bool                       m_framebuffer_resized    = true;
+
+    JobSystem        m_job_system        = {};
+    ParallelRecorder m_parallel_recorder = {};
+
+    GpuProfiler m_gpu_profiler = {};
+    FrameTracer m_frame_tracer = {};
+
+    // Headless benchmark state.
+    FrameTimings m_frame_timings = {};
+
+    // --stream-mb: stream_mb MiB are uploaded into the frame's region of m_stream_buffer every frame.
+    Buffer                 m_stream_buffer = {};
+    std::vector<std::byte> m_stream_data   = {};
+
+    // --pipeline-threads: pipelines compile in the background, m_pipeline_fallback is set for a frame in which
+    // resolve_pipeline() had to fall back.
+    PipelineCompiler m_pipeline_compiler        = {};
+    bool             m_pipeline_fallback        = false;
+    uint64_t         m_pipeline_fallback_frames = 0;
+
+    // --hot-reload: shaders saved while running are recompiled by the watcher and their pipelines rebuilt between
+    // frames by reload_shaders().
+    ShaderWatcher m_shader_watcher = {};
+
+   protected:
+    ApplicationOptions m_options            = {};
+    DeviceContext      m_context            = {};
+    Swapchain          m_swapchain          = {};
+    VkRenderPass       m_render_pass        = VK_NULL_HANDLE;  // null with dynamic rendering
+    RenderPassLayout   m_render_pass_layout = {};              // what the scene's pipelines must be compatible with
+
+    UploadContext      m_upload_context   = {};
+    UploadScheduler    m_upload_scheduler = {};  // flushed every frame and acquired before the prepass
+    FrameRingBuffer    m_frame_ring       = {};  // per-frame dynamic data, rewound before update_scene()
+    BindlessTable      m_bindless_table   = {};  // only with --bindless on devices with descriptor indexing
+    PipelineCache      m_pipeline_cache   = {};
+    PipelineStateCache m_pipeline_states  = {};  // owns the graphics pipelines, destroyed after destroy_scene()
+    ShaderArchive      m_shader_archive   = {};  // not open without a packed build, shaders then load from bin/shaders
+
+   public:
+    Application(std::string name, const ApplicationOptions& options);
+    virtual ~Application() = default;
+
+    void run();
+
+   protected:
+    /* ---- Scene hooks ---- */
+
+    // Called once the device, swapchain and render pass exist. Get graphics pipelines with request_pipeline() and
+    // create any other pipeline with m_pipeline_cache.handle() and &m_shader_archive.
+    virtual void create_scene() = 0;
+
+    // Called after the device went idle, before the device is destroyed.
+    virtual void destroy_scene() = 0;
+
+    // Called every frame once frame_index's previous submission has completed and before recording, so per-frame
+    // resources of that slot (e.g. instance data) may be rewritten here. Uploads issued through m_upload_scheduler
+    // are flushed afterwards and visible to the frame's commands.
+    virtual void update_scene(uint32_t frame_index) { (void)frame_index; }
+
+    // Records work that has to happen before the render pass in the frame's primary command buffer, e.g. a compute
+    // pass producing indirect draws. Runs after update_scene().
+    virtual void record_prepass(VkCommandBuffer command_buffer) { (void)command_buffer; }
+
+    // Number of independent draws the scene records; ranges of them may be recorded on different threads.
+    virtual uint32_t scene_draw_count() const { return 1; }
+
+    // Records draws [first_draw, first_draw + draw_count). The render pass is begun and viewport/scissor are set.
+    // With --threads > 1 this runs concurrently on several workers, each into its own secondary command buffer,
+    // so it must not modify shared state.
+    virtual void record_scene(VkCommandBuffer command_buffer, uint32_t first_draw, uint32_t draw_count) = 0;
+
+    /* ---- Pipelines ---- */
+
+    // Requests the graphics pipeline for desc against m_render_pass and returns the key to resolve it with. It is
+    // created right away, or on a background thread with --pipeline-threads.
+    uint64_t request_pipeline(const GraphicsPipelineDesc& desc);
+
+    // The pipeline for key once it has been compiled, fallback until then; a null fallback means the draw should be
+    // skipped. Call from update_scene(), frames that fell back are counted in the benchmark report.
+    GraphicsPipeline resolve_pipeline(uint64_t key, const GraphicsPipeline& fallback = {});
+
+   private:
+    /* ---- Initialization and lifecycle ---- */
+
+    void        init();
+    void        init_glfw();
+    void        init_window();
+    static void framebuffer_resize_callback(GLFWwindow* window, int width, int height);
+    void        init_vulkan();
+    void        main_loop();
+    void        cleanup();
+
+    /* ---- Frame loop ---- */
+
+    void create_framebuffers();
+    void destroy_framebuffers();
+    void recreate_swapchain();
+    void record_command_buffer(const FrameContext& frame);
+    void begin_rendering(VkCommandBuffer command_buffer, const FrameContext& frame, bool secondary);
+    void end_rendering(VkCommandBuffer command_buffer, const FrameContext& frame);
+    void set_viewport_and_scissor(VkCommandBuffer command_buffer);
+    void stream_uploads(uint32_t frame_index);
+    void reload_shaders();
+    void draw_frame();
+
+    /* ---- Headless benchmark ---- */
+
+    void run_benchmark();
+    void run_record_sweep();
+    void run_instance_sweep();
+    void set_record_threads(uint32_t thread_count);
+    void print_benchmark_report(uint32_t frame_count, double elapsed_s);
+    void collect_gpu_profile(uint32_t slot);
+};
+
+}  // namespace renderer
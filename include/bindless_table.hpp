@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "device_context.hpp"
+#include "frame_scheduler.hpp"
+
+namespace renderer {
+
+// Free-list allocator of array slots. A released slot may still be read by frames in flight, so it is retired
+// together with the frame value after which nothing references it and only handed out again once that frame has
+// completed.
+class SlotAllocator {
+   private:
+    class RetiredSlot {
+       public:
+        uint32_t slot         = 0;
+        uint64_t retire_value = 0;
+    };
+
+    uint32_t                m_capacity = 0;
+    uint32_t                m_next     = 0;  // slots at or above m_next have never been handed out
+    std::vector<uint32_t>   m_free;
+    std::deque<RetiredSlot> m_retired;       // in increasing retire_value order
+
+   public:
+    void init(uint32_t capacity);
+
+    std::optional<uint32_t> allocate();
+    void                    release(uint32_t slot, uint64_t retire_value);
+
+    // Moves the retired slots whose frames have completed to the free list.
+    void reclaim(FrameScheduler& frame_scheduler);
+
+    uint32_t capacity() const { return m_capacity; }
+    uint32_t live_count() const {
+        return m_next - static_cast<uint32_t>(m_free.size()) - static_cast<uint32_t>(m_retired.size());
+    }
+};
+
+// One descriptor set holding every storage buffer and sampled image of the renderer in two large arrays. Shaders
+// index them with slots passed in push constants, so a pipeline binds the set once per command buffer instead of a
+// set per draw. Slots are written with UPDATE_AFTER_BIND while the set stays bound in frames in flight, and an array
+// only needs to be populated where it is read (PARTIALLY_BOUND).
+//
+// Shaders declare the arrays as
+//     layout(set = 0, binding = 0) readonly buffer Buffers { ... } buffers[];
+//     layout(set = 0, binding = 1) uniform sampler2D images[];
+// Requires DeviceFeatures::descriptor_indexing.
+class BindlessTable {
+   public:
+    static constexpr uint32_t STORAGE_BUFFER_BINDING = 0;
+    static constexpr uint32_t SAMPLED_IMAGE_BINDING  = 1;
+    static constexpr uint32_t INVALID_SLOT           = std::numeric_limits<uint32_t>::max();
+
+   private:
+    // Upper bounds; the device's update-after-bind limits may lower them.
+    static constexpr uint32_t MAX_STORAGE_BUFFERS = 1 << 16;
+    static constexpr uint32_t MAX_SAMPLED_IMAGES  = 1 << 14;
+
+    const DeviceContext* m_context         = nullptr;
+    FrameScheduler*      m_frame_scheduler = nullptr;
+
+    VkDescriptorSetLayout m_set_layout      = VK_NULL_HANDLE;
+    VkDescriptorPool      m_descriptor_pool = VK_NULL_HANDLE;
+    VkDescriptorSet       m_descriptor_set  = VK_NULL_HANDLE;
+
+    SlotAllocator m_buffer_slots = {};
+    SlotAllocator m_image_slots  = {};
+
+   public:
+    static bool supported(const DeviceContext& context) { return context.features().descriptor_indexing; }
+
+    // Slots are retired against frame_scheduler's frame values.
+    void init(const DeviceContext& context, FrameScheduler& frame_scheduler);
+    void cleanup();
+
+    // Writes the descriptor into a free slot and returns it. Throws when the array is full.
+    uint32_t add_storage_buffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+    uint32_t add_sampled_image(VkImageView image_view, VkSampler sampler,
+                               VkImageLayout image_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    // The slot is reused once the frame being recorded, and every frame before it, has completed.
+    void release_storage_buffer(uint32_t slot);
+    void release_sampled_image(uint32_t slot);
+
+    // Call once per frame to recycle released slots.
+    void reclaim();
+
+    // Binds the table as set 0 of layout, which must have been created with set_layout() as its first set.
+    void bind(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, VkPipelineLayout layout) const;
+
+    VkDescriptorSetLayout set_layout() const { return m_set_layout; }
+    uint32_t              storage_buffer_count() const { return m_buffer_slots.live_count(); }
+    uint32_t              sampled_image_count() const { return m_image_slots.live_count(); }
+
+   private:
+    uint64_t retire_value() const;
+};
+
+}  // namespace renderer
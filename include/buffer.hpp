@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+#include "allocator.hpp"
+#include "device_context.hpp"
+#include "gpu_profiler.hpp"
+
+namespace renderer {
+
+class Buffer {
+   public:
+    VkBuffer     buffer     = VK_NULL_HANDLE;
+    Allocation   allocation = {};
+    VkDeviceSize size       = 0;
+};
+
+// Memory comes from the context's DeviceAllocator; HOST_VISIBLE buffers are already mapped at allocation.mapped.
+Buffer create_buffer(const DeviceContext& context, VkDeviceSize size, VkBufferUsageFlags usage,
+                     VkMemoryPropertyFlags properties, AllocationStrategy strategy = AllocationStrategy::Buddy);
+void   destroy_buffer(const DeviceContext& context, Buffer& buffer);
+
+// Copies host data into DEVICE_LOCAL buffers through one persistently mapped HOST_VISIBLE staging buffer.
+// Uploads larger than the staging buffer are streamed through it in chunks, so host memory use stays bounded
+// no matter how large the mesh is.
+class UploadContext {
+   private:
+    static constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 16 * 1024 * 1024;
+
+    const DeviceContext* m_context        = nullptr;
+    VkQueue              m_queue          = VK_NULL_HANDLE;
+    VkCommandPool        m_command_pool   = VK_NULL_HANDLE;
+    VkCommandBuffer      m_command_buffer = VK_NULL_HANDLE;
+    VkFence              m_fence          = VK_NULL_HANDLE;
+    Buffer               m_staging_buffer = {};
+    GpuProfiler*         m_profiler       = nullptr;
+
+   public:
+    void init(const DeviceContext& context, VkDeviceSize staging_size = DEFAULT_STAGING_SIZE);
+    void cleanup();
+
+    // Times every upload chunk in the profiler's UPLOAD_SLOT under an "upload" scope.
+    void set_profiler(GpuProfiler* profiler) { m_profiler = profiler; }
+
+    // Creates a DEVICE_LOCAL buffer with usage | TRANSFER_DST and fills it with data.
+    Buffer create_device_local_buffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage);
+
+    // Blocks until the data has been copied into dst_buffer at dst_offset.
+    void upload(VkBuffer dst_buffer, VkDeviceSize dst_offset, const void* data, VkDeviceSize size);
+
+   private:
+    void submit_copy(VkBuffer dst_buffer, VkDeviceSize dst_offset, VkDeviceSize size);
+};
+
+}  // namespace renderer
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace renderer {
+
+// The Makefile's CONFIG (debug, release, lto or pgo), printed with benchmark results so that numbers from one build are
+// never mistaken for another's.
+#ifdef BUILD_CONFIG
+inline constexpr const char* BUILD_CONFIG_NAME = BUILD_CONFIG;
+#else
+inline constexpr const char* BUILD_CONFIG_NAME = "unknown";
+#endif
+
+}  // namespace renderer
@@ -0,0 +1,143 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "allocator.hpp"
+
+namespace renderer {
+
+#ifdef NDEBUG
+inline constexpr bool ENABLE_VALIDATION_LAYERS = false;
+#else
+inline constexpr bool ENABLE_VALIDATION_LAYERS = true;
+#endif
+
+class QueueFamilyIndices {
+   public:
+    std::optional<uint32_t> graphics_family;
+    std::optional<uint32_t> present_family;
+    std::optional<uint32_t> compute_family;   // a compute-only family if there is one, else the graphics family
+    std::optional<uint32_t> transfer_family;  // a family without graphics if there is one, else the graphics family
+
+    bool is_complete() const { return graphics_family.has_value() && present_family.has_value(); }
+};
+
+// Optional features negotiated at device creation; each is only true if it was also enabled on the device.
+class DeviceFeatures {
+   public:
+    uint32_t api_version                  = VK_API_VERSION_1_0;  // min(instance, device) version actually in use
+    bool     timeline_semaphore           = false;
+    bool     multi_draw_indirect          = false;               // drawCount > 1 in one vkCmdDraw*Indirect
+    bool     draw_indirect_first_instance = false;               // firstInstance other than 0 in indirect draw commands
+    bool     draw_indirect_count          = false;               // vkCmdDraw*IndirectCount, GPU-written draw count
+    bool     descriptor_indexing          = false;               // update-after-bind, partially bound descriptor arrays
+    bool     dynamic_rendering            = false;               // VK_KHR_dynamic_rendering, no render pass objects
+};
+
+class SwapChainSupportDetails {
+   public:
+    VkSurfaceCapabilitiesKHR        capabilities;
+    std::vector<VkSurfaceFormatKHR> formats;
+    std::vector<VkPresentModeKHR>   present_modes;
+};
+
+// Owns the instance, the (optional) window surface, the physical/logical device and its queues.
+// Passing a null window creates a headless context: no surface, no swapchain extension, and the graphics
+// queue doubles as the present queue.
+class DeviceContext {
+   private:
+    // Highest version the renderer knows how to use; older instances and devices fall back feature by feature.
+    static constexpr uint32_t TARGET_API_VERSION = VK_API_VERSION_1_2;
+
+    GLFWwindow*              m_window               = nullptr;
+    VkInstance               m_instance             = VK_NULL_HANDLE;
+    VkDebugUtilsMessengerEXT m_debug_messenger      = VK_NULL_HANDLE;
+    VkSurfaceKHR             m_surface              = VK_NULL_HANDLE;
+    VkPhysicalDevice         m_physical_device      = VK_NULL_HANDLE;
+    VkDevice                 m_logical_device       = VK_NULL_HANDLE;
+    VkQueue                  m_graphics_queue       = VK_NULL_HANDLE;
+    VkQueue                  m_present_queue        = VK_NULL_HANDLE;
+    VkQueue                  m_compute_queue        = VK_NULL_HANDLE;
+    VkQueue                  m_transfer_queue       = VK_NULL_HANDLE;
+    QueueFamilyIndices       m_queue_family_indices = {};
+    uint32_t                 m_instance_version     = VK_API_VERSION_1_0;
+    DeviceFeatures           m_features             = {};
+
+    // Extension entry points, only loaded with the matching feature.
+    PFN_vkCmdBeginRenderingKHR m_cmd_begin_rendering = nullptr;
+    PFN_vkCmdEndRenderingKHR   m_cmd_end_rendering   = nullptr;
+
+    // Every buffer and image is sub-allocated from here instead of calling vkAllocateMemory itself.
+    std::unique_ptr<VulkanMemoryBackend> m_memory_backend = nullptr;
+    mutable DeviceAllocator              m_allocator;
+
+    std::string m_application_name = {};
+
+    const std::vector<const char*> m_validation_layers = {"VK_LAYER_KHRONOS_validation"};
+    std::vector<const char*>       m_device_extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+
+   public:
+    void init(const std::string& application_name, GLFWwindow* window);
+    void cleanup();
+
+    bool                      headless() const { return m_window == nullptr; }
+    GLFWwindow*               window() const { return m_window; }
+    VkInstance                instance() const { return m_instance; }
+    VkSurfaceKHR              surface() const { return m_surface; }
+    VkPhysicalDevice          physical_device() const { return m_physical_device; }
+    VkDevice                  device() const { return m_logical_device; }
+    VkQueue                   graphics_queue() const { return m_graphics_queue; }
+    VkQueue                   present_queue() const { return m_present_queue; }
+    VkQueue                   compute_queue() const { return m_compute_queue; }
+    VkQueue                   transfer_queue() const { return m_transfer_queue; }
+    const QueueFamilyIndices& queue_family_indices() const { return m_queue_family_indices; }
+    DeviceAllocator&          allocator() const { return m_allocator; }
+    const DeviceFeatures&     features() const { return m_features; }
+
+    // Require features().dynamic_rendering.
+    void cmd_begin_rendering(VkCommandBuffer command_buffer, const VkRenderingInfoKHR& rendering_info) const {
+        m_cmd_begin_rendering(command_buffer, &rendering_info);
+    }
+    void cmd_end_rendering(VkCommandBuffer command_buffer) const { m_cmd_end_rendering(command_buffer); }
+
+    SwapChainSupportDetails query_swapchain_support_details() const;
+    uint32_t                find_memory_type(uint32_t type_filter, VkMemoryPropertyFlags properties) const;
+
+   private:
+    /* ---- Instance creation and validation layer helpers ---- */
+
+    void                     create_instance();
+    uint32_t                 negotiate_instance_version();
+    void                     check_extension_support();
+    bool                     check_validation_layer_support();
+    std::vector<const char*> get_required_extensions();
+    void                     setup_debug_messenger();
+    void                     create_surface();
+
+    /* ---- Physical and logical device selection ---- */
+
+    void                    pick_physical_device();
+    uint32_t                rate_physical_device(VkPhysicalDevice device);
+    bool                    is_physical_device_suitable(VkPhysicalDevice device);
+    bool                    check_physical_device_extension_support(VkPhysicalDevice device);
+    bool                    has_device_extension(const char* extension_name) const;
+    bool                    check_swapchain_support(VkPhysicalDevice device);
+    QueueFamilyIndices      find_queue_familiy_indices(VkPhysicalDevice physical_device);
+    std::optional<uint32_t> find_compute_queue_family(VkPhysicalDevice physical_device) const;
+    std::optional<uint32_t> find_transfer_queue_family(VkPhysicalDevice physical_device,
+                                                       std::optional<uint32_t> graphics_family) const;
+    void                    negotiate_device_features();
+    SwapChainSupportDetails query_swapchain_support_details(VkPhysicalDevice physical_device) const;
+    void                    create_logical_device();
+    void                    create_allocator();
+};
+
+}  // namespace renderer
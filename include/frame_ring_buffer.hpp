@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "buffer.hpp"
+#include "device_context.hpp"
+#include "frame_scheduler.hpp"
+
+namespace renderer {
+
+class FrameRingAllocation {
+   public:
+    VkBuffer     buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;        // from the start of buffer, usable as a dynamic or binding offset
+    void*        data   = nullptr;  // persistently mapped, write-only for the host
+};
+
+// Per-frame dynamic data (uniforms, streamed vertices, instance data) without mapping or allocating on the hot path.
+// One persistently mapped buffer is split into MAX_FRAMES_IN_FLIGHT regions; allocate() bumps a pointer through the
+// current frame's region and begin_frame() rewinds a region once the frame that last used it has completed.
+//
+// The buffer lives in DEVICE_LOCAL | HOST_VISIBLE memory when the device exposes a large enough heap of it
+// (resizable BAR, or unified memory), and in HOST_VISIBLE | HOST_COHERENT system memory otherwise.
+class FrameRingBuffer {
+   public:
+    static constexpr VkDeviceSize DEFAULT_REGION_SIZE = 4 * 1024 * 1024;
+
+   private:
+    // Regions start at multiples of this, the largest min*BufferOffsetAlignment the spec allows.
+    static constexpr VkDeviceSize REGION_ALIGNMENT = 256;
+
+    const DeviceContext* m_context       = nullptr;
+    VkBufferUsageFlags   m_usage         = 0;
+    Buffer               m_buffer        = {};
+    VkDeviceSize         m_region_size   = 0;
+    VkDeviceSize         m_min_alignment = 1;  // for uniform and storage offsets, per the device limits
+    bool                 m_device_local  = false;
+    uint32_t             m_frame_index   = 0;
+    VkDeviceSize         m_peak_used     = 0;  // largest number of bytes one frame allocated
+
+    std::atomic<VkDeviceSize> m_head = 0;  // bytes of the current region handed out
+
+   public:
+    // usage is the set of buffer usages the allocations will be bound as, e.g. VERTEX_BUFFER | UNIFORM_BUFFER.
+    void init(const DeviceContext& context, VkBufferUsageFlags usage, VkDeviceSize region_size = DEFAULT_REGION_SIZE);
+    void cleanup();
+
+    // Rewinds frame_index's region and makes it current. Call once per frame after FrameScheduler::begin_frame(),
+    // i.e. once the frame that last used the region has completed.
+    void begin_frame(uint32_t frame_index);
+
+    // Grows every region to at least region_size bytes. Growing waits for the device to go idle and drops the
+    // allocations of the current frame, so call it before allocating.
+    void reserve(VkDeviceSize region_size);
+
+    // Returns size bytes of the current region, aligned to alignment and to the device's uniform/storage offset
+    // alignment. Thread-safe, so secondary command buffers may allocate while recording. Throws when the region is
+    // exhausted.
+    FrameRingAllocation allocate(VkDeviceSize size, VkDeviceSize alignment = 1);
+
+    VkBuffer     buffer() const { return m_buffer.buffer; }
+    VkDeviceSize region_size() const { return m_region_size; }
+    VkDeviceSize peak_used() const { return m_peak_used; }
+    bool         device_local() const { return m_device_local; }
+
+   private:
+    void create_ring(VkDeviceSize region_size);
+};
+
+}  // namespace renderer
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "device_context.hpp"
+#include "frame_tracer.hpp"
+#include "swapchain.hpp"
+
+namespace renderer {
+
+inline constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+
+// How a frame's command buffer is recycled once its fence has signaled.
+enum class CommandPoolStrategy {
+    PerFramePool,    // one transient pool per frame in flight, reset with a single vkResetCommandPool
+    PerBufferReset,  // RESET_COMMAND_BUFFER_BIT pools, each buffer reset with vkResetCommandBuffer
+};
+
+// How the CPU learns that a frame's GPU work has completed.
+enum class FrameSyncMode {
+    Fences,    // a fence per frame in flight, plus a fence per swapchain image to guard reuse of that image
+    Timeline,  // one timeline semaphore whose value counts submitted frames (Vulkan 1.2)
+};
+
+class FrameSchedulerStats {
+   public:
+    uint64_t frames                = 0;
+    uint64_t command_pool_resets   = 0;
+    uint64_t command_buffer_resets = 0;
+    double   reset_ms              = 0.0;  // CPU time spent in the reset calls
+    uint64_t host_waits            = 0;    // vkWaitForFences / vkWaitSemaphores calls issued
+};
+
+class FrameContext {
+   public:
+    uint32_t        frame_index    = 0;
+    uint32_t        image_index    = 0;
+    VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+};
+
+class SemaphoreWait {
+   public:
+    VkSemaphore          semaphore = VK_NULL_HANDLE;  // a timeline semaphore
+    uint64_t             value     = 0;
+    VkPipelineStageFlags stage     = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+};
+
+// Owns the per-frame-in-flight command buffers and synchronization objects and drives the
+// wait -> acquire -> record -> submit -> present cycle against a Swapchain.
+class FrameScheduler {
+   private:
+    static constexpr uint32_t MAX_EXTRA_WAITS = 4;
+
+    const DeviceContext* m_context  = nullptr;
+    CommandPoolStrategy  m_strategy  = CommandPoolStrategy::PerFramePool;
+    FrameSyncMode        m_sync_mode = FrameSyncMode::Fences;
+    FrameSchedulerStats  m_stats     = {};
+    FrameTracer*         m_tracer    = nullptr;
+
+    std::array<VkCommandPool, MAX_FRAMES_IN_FLIGHT>   m_command_pools              = {VK_NULL_HANDLE};
+    std::array<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT> m_command_buffers            = {VK_NULL_HANDLE};
+    std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT>     m_semaphores_image_available = {VK_NULL_HANDLE};
+    std::array<VkFence, MAX_FRAMES_IN_FLIGHT>         m_fences_in_flight           = {VK_NULL_HANDLE};
+
+    std::vector<VkFence> m_images_in_flight;
+
+    // Every submitted frame gets the next value of one counter: in timeline mode it is signaled on m_frame_timeline,
+    // in fence mode it is recovered from the frame fences. Either way resources can be tagged with a value and
+    // reclaimed once is_complete() says so.
+    VkSemaphore                                m_frame_timeline  = VK_NULL_HANDLE;
+    uint64_t                                   m_submitted_value = 0;
+    uint64_t                                   m_completed_value = 0;
+    std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_frame_values    = {0};
+    std::vector<uint64_t>                      m_image_values;
+
+    // Extra timeline waits of the next submit, e.g. on uploads running on another queue.
+    std::array<SemaphoreWait, MAX_EXTRA_WAITS> m_extra_waits      = {};
+    uint32_t                                   m_extra_wait_count = 0;
+
+    uint32_t m_current_frame = 0;
+
+   public:
+    // Timeline mode falls back to fences when the device does not support timeline semaphores.
+    void init(const DeviceContext& context, uint32_t image_count,
+              CommandPoolStrategy strategy = CommandPoolStrategy::PerFramePool,
+              FrameSyncMode       sync_mode = FrameSyncMode::Timeline);
+    void cleanup();
+
+    // Records the wait_fence, acquire, wait_image, submit and present stages of every frame.
+    void set_tracer(FrameTracer* tracer) { m_tracer = tracer; }
+
+    // Must be called whenever the swapchain has been (re)created with a different set of images.
+    void reset_images_in_flight(uint32_t image_count);
+
+    // Waits until the current frame slot is free, acquires an image and recycles the frame's command buffer.
+    // Returns false if the swapchain is out of date and has to be recreated before rendering.
+    bool begin_frame(Swapchain& swapchain, FrameContext& frame);
+
+    // Makes the next end_frame() submit wait for a timeline semaphore to reach a value. A semaphore that is already
+    // waited on only has its value raised.
+    void add_wait(const SemaphoreWait& wait);
+
+    // Submits the frame's command buffer and presents the image.
+    // Returns false if the swapchain is out of date or suboptimal and should be recreated.
+    bool end_frame(Swapchain& swapchain, const FrameContext& frame);
+
+    // Value that completes with the most recently submitted frame; 0 before the first submit.
+    uint64_t submitted_value() const { return m_submitted_value; }
+
+    // True once the GPU finished every frame up to and including value. Never blocks.
+    bool is_complete(uint64_t value);
+
+    uint32_t                   current_frame() const { return m_current_frame; }
+    CommandPoolStrategy        strategy() const { return m_strategy; }
+    FrameSyncMode              sync_mode() const { return m_sync_mode; }
+    const FrameSchedulerStats& stats() const { return m_stats; }
+
+   private:
+    void wait_for_frame(uint32_t frame);
+    void wait_for_value(uint64_t value);
+    void refresh_completed_value();
+    void create_command_pools();
+    void reset_command_buffer(uint32_t frame);
+    void create_command_buffers();
+    void create_synchonization_objects();
+};
+
+}  // namespace renderer
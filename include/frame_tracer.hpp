@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace renderer {
+
+// Log-linear latency histogram: every power of two is split into SUB_BUCKETS linear buckets, so a percentile is
+// off by at most 1/SUB_BUCKETS of its value while the histogram stays a fixed-size array.
+class LatencyHistogram {
+   private:
+    static constexpr uint32_t SUB_BUCKET_BITS = 4;
+    static constexpr uint32_t SUB_BUCKETS     = 1u << SUB_BUCKET_BITS;
+    static constexpr uint32_t BUCKET_COUNT    = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    std::array<uint64_t, BUCKET_COUNT> m_buckets  = {};
+    uint64_t                           m_count    = 0;
+    uint64_t                           m_total_ns = 0;
+    uint64_t                           m_min_ns   = UINT64_MAX;
+    uint64_t                           m_max_ns   = 0;
+
+   public:
+    void record(uint64_t ns);
+
+    // percentile in [0, 100]; returns the upper bound of the bucket holding it.
+    uint64_t percentile_ns(double percentile) const;
+
+    uint64_t count() const { return m_count; }
+    uint64_t min_ns() const { return m_count > 0 ? m_min_ns : 0; }
+    uint64_t max_ns() const { return m_max_ns; }
+    double   mean_ns() const { return m_count > 0 ? static_cast<double>(m_total_ns) / m_count : 0.0; }
+
+    // Bucket holding ns, and the largest value that still falls into bucket index.
+    static uint32_t bucket_index(uint64_t ns);
+    static uint64_t bucket_upper_bound(uint32_t index);
+};
+
+// CPU-side stage timings. Every thread records into its own single-producer ring, so recording an event is a few
+// relaxed stores and one release store, with no lock and no allocation. drain() folds the rings into per-stage
+// histograms and, optionally, appends the events to a Chrome trace-event JSON file (chrome://tracing, Perfetto).
+// If a ring overflows between two drains the oldest events are dropped and counted.
+class FrameTracer {
+   public:
+    // Times the enclosing block, or up to end(). A null tracer makes it a no-op.
+    class Scope {
+       private:
+        FrameTracer* m_tracer   = nullptr;
+        const char*  m_name     = nullptr;
+        uint64_t     m_start_ns = 0;
+
+       public:
+        // name must outlive the tracer, in practice a string literal.
+        Scope(FrameTracer* tracer, const char* name);
+        ~Scope() { end(); }
+
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        void end();
+    };
+
+   private:
+    static constexpr uint64_t RING_CAPACITY = 1024;  // power of two
+
+    class Ring {
+       public:
+        std::array<std::atomic<const char*>, RING_CAPACITY> names        = {};
+        std::array<std::atomic<uint64_t>, RING_CAPACITY>    starts_ns    = {};
+        std::array<std::atomic<uint64_t>, RING_CAPACITY>    durations_ns = {};
+        std::atomic<uint64_t>                               head         = 0;  // written by the owning thread only
+        uint64_t                                            tail         = 0;  // read by drain() only
+        uint32_t                                            thread_index = 0;
+    };
+
+    uint64_t                              m_id    = 0;  // tells this tracer apart in the per-thread ring cache
+    std::chrono::steady_clock::time_point m_epoch = {};
+
+    std::mutex                         m_rings_mutex;  // taken once per thread on its first event, and by drain()
+    std::vector<std::unique_ptr<Ring>> m_rings = {};
+
+    std::map<std::string, LatencyHistogram, std::less<>> m_histograms = {};
+    uint64_t                                             m_dropped    = 0;
+
+    std::ofstream m_trace       = {};
+    bool          m_trace_empty = true;
+
+   public:
+    // An empty trace_path disables the trace file.
+    void init(const std::string& trace_path = "");
+    void cleanup();
+
+    uint64_t now_ns() const;
+    void     record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+    // Call from one thread at a time, e.g. once per frame from the frame loop.
+    void drain();
+
+    const std::map<std::string, LatencyHistogram, std::less<>>& histograms() const { return m_histograms; }
+    void                                                        print_report(std::ostream& out) const;
+
+   private:
+    Ring& thread_ring();
+    void  write_trace_event(const char* name, uint32_t thread_index, uint64_t start_ns, uint64_t duration_ns);
+};
+
+}  // namespace renderer
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+
+#include "buffer.hpp"
+#include "device_context.hpp"
+#include "frame_scheduler.hpp"
+#include "math.hpp"
+#include "pipeline.hpp"
+
+namespace renderer {
+
+// GPU-driven draw submission. Every frame the host writes one bounding sphere per object; a compute pass
+// (shaders/cull.comp) tests them against the frustum and writes one VkDrawIndexedIndirectCommand per object that
+// survives, with firstInstance set to the object's index, and the render pass consumes the commands with a single
+// indirect draw call. Survivors are compacted behind a GPU-written count when the device has drawIndirectCount;
+// otherwise every object keeps its slot and culled ones become draws with instanceCount 0. A non-zero firstInstance
+// needs drawIndirectFirstInstance, so the culler is only available on devices that have it.
+//
+// All buffers are split into one region per frame in flight, so the host and the GPU never touch the same region.
+class GpuCuller {
+   public:
+    static constexpr uint32_t WORKGROUP_SIZE = 64;  // local_size_x in shaders/cull.comp
+
+   private:
+    static constexpr const char* SHADER_PATH = "bin/shaders/cull.comp.spv";
+
+    // Object capacities are multiples of this, so every region starts at a multiple of 256 bytes, the largest
+    // minStorageBufferOffsetAlignment the spec allows.
+    static constexpr uint32_t CAPACITY_GRANULARITY = 64;
+    static constexpr uint32_t COUNT_REGION_SIZE    = 256;
+
+    // Matches the Cull push constant block in shaders/cull.comp.
+    class PushConstants {
+       public:
+        std::array<math::Vec4, 6> planes       = {};
+        uint32_t                  object_count = 0;
+        uint32_t                  index_count  = 0;
+        uint32_t                  compact      = 0;
+    };
+
+    const DeviceContext* m_context = nullptr;
+
+    VkDescriptorSetLayout                             m_set_layout      = VK_NULL_HANDLE;
+    VkDescriptorPool                                  m_descriptor_pool = VK_NULL_HANDLE;
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_descriptor_sets = {VK_NULL_HANDLE};
+    ComputePipeline                                   m_pipeline        = {};
+
+    Buffer   m_bounds_buffer = {};  // HOST_VISIBLE, math::Vec4 per object
+    Buffer   m_draw_buffer   = {};  // DEVICE_LOCAL, VkDrawIndexedIndirectCommand per object
+    Buffer   m_count_buffer  = {};  // DEVICE_LOCAL, one uint32_t per frame, COUNT_REGION_SIZE apart
+    uint32_t m_capacity      = 0;   // objects per frame region
+    bool     m_compact       = false;
+    bool     m_multi_draw    = false;
+
+   public:
+    static bool supported(const DeviceContext& context) { return context.features().draw_indirect_first_instance; }
+
+    void init(const DeviceContext& context, VkPipelineCache pipeline_cache = VK_NULL_HANDLE,
+              const ShaderArchive* shader_archive = nullptr);
+    void cleanup();
+
+    // Grows the per-frame regions to hold object_count objects. Growing waits for the device to go idle.
+    void reserve(uint32_t object_count);
+
+    // Mapped bounding spheres of frame_index's region (xyz center, w radius), written by the host before record_cull.
+    math::Vec4* bounds(uint32_t frame_index) const;
+
+    // True if draws are compacted and counted on the GPU (vkCmdDrawIndexedIndirectCount).
+    bool compacting() const { return m_compact; }
+
+    // Records the cull dispatch for object_count objects and the barrier that makes its output visible to indirect
+    // draws. Must be recorded outside a render pass, before the render pass that calls record_draws.
+    void record_cull(VkCommandBuffer command_buffer, uint32_t frame_index, uint32_t object_count,
+                     const std::array<math::Vec4, 6>& frustum_planes, uint32_t index_count);
+
+    // Issues the culled draws; the graphics pipeline, vertex and index buffers must already be bound.
+    void record_draws(VkCommandBuffer command_buffer, uint32_t frame_index, uint32_t object_count);
+
+   private:
+    void         create_buffers(uint32_t capacity);
+    void         destroy_buffers();
+    void         write_descriptor_sets();
+    VkDeviceSize draw_region_offset(uint32_t frame_index) const;
+};
+
+}  // namespace renderer
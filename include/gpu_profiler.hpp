@@ -0,0 +1,121 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "device_context.hpp"
+#include "frame_scheduler.hpp"
+
+namespace renderer {
+
+class GpuScopeSample {
+   public:
+    std::string name        = {};
+    uint32_t    depth       = 0;
+    double      start_ms    = 0.0;  // relative to the start of the root scope
+    double      duration_ms = 0.0;
+};
+
+class GpuFrameProfile {
+   public:
+    uint64_t                    sequence = 0;
+    std::vector<GpuScopeSample> scopes   = {};  // scopes[0] is the root scope
+};
+
+class GpuScopeStats {
+   public:
+    uint64_t count   = 0;
+    double   last_ms = 0.0;
+    double   avg_ms  = 0.0;
+    double   min_ms  = 0.0;
+    double   max_ms  = 0.0;
+};
+
+// Timestamp query profiler. Every slot (one per frame in flight, plus one for uploads) owns a query pool, so a
+// slot's results are read back only after its fence signaled, with VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+// instead of a wait. Named scopes nest; each collected slot yields a GpuFrameProfile that feeds rolling
+// per-scope stats and, optionally, a trace file (.json, anything else is CSV) that can be diffed between builds.
+class GpuProfiler {
+   public:
+    static constexpr uint32_t UPLOAD_SLOT = MAX_FRAMES_IN_FLIGHT;
+    static constexpr uint32_t SLOT_COUNT  = MAX_FRAMES_IN_FLIGHT + 1;
+
+   private:
+    static constexpr uint32_t MAX_SCOPES   = 64;
+    static constexpr uint32_t STATS_WINDOW = 256;
+
+    class PendingScope {
+       public:
+        const char* name        = nullptr;
+        uint32_t    depth       = 0;
+        uint32_t    begin_query = 0;
+        uint32_t    end_query   = 0;
+    };
+
+    class Slot {
+       public:
+        VkQueryPool               query_pool = VK_NULL_HANDLE;
+        std::vector<PendingScope> scopes     = {};
+        uint32_t                  next_query = 0;
+        uint32_t                  depth      = 0;
+        bool                      pending    = false;
+    };
+
+    class ScopeWindow {
+       public:
+        std::vector<double> samples = {};
+        size_t              next    = 0;
+        uint64_t            count   = 0;
+    };
+
+    const DeviceContext*               m_context        = nullptr;
+    bool                               m_enabled        = false;
+    double                             m_ns_per_tick    = 0.0;
+    uint64_t                           m_timestamp_mask = ~0ull;
+    uint64_t                           m_sequence       = 0;
+    uint64_t                           m_missed         = 0;
+    std::array<Slot, SLOT_COUNT>       m_slots          = {};
+    std::map<std::string, ScopeWindow> m_windows        = {};
+    GpuFrameProfile                    m_last_profile   = {};
+
+    std::ofstream m_trace       = {};
+    bool          m_trace_json  = false;
+    bool          m_trace_empty = true;
+
+   public:
+    // An empty trace_path disables the trace file. Profiling is disabled on queues without timestamp support.
+    void init(const DeviceContext& context, const std::string& trace_path = "");
+    void cleanup();
+
+    bool enabled() const { return m_enabled; }
+
+    // Resets the slot's queries and opens its root scope. Must be recorded outside of a render pass.
+    void begin(VkCommandBuffer command_buffer, uint32_t slot, const char* root_name);
+    void end(VkCommandBuffer command_buffer, uint32_t slot);
+
+    // Returns a scope handle for end_scope(); scopes past MAX_SCOPES are silently dropped.
+    uint32_t begin_scope(VkCommandBuffer command_buffer, uint32_t slot, const char* name);
+    void     end_scope(VkCommandBuffer command_buffer, uint32_t slot, uint32_t scope);
+
+    // Call once the slot's submission has completed (its fence signaled). Returns nullptr if nothing was
+    // pending or the results are not available; the profile stays valid until the next collect().
+    const GpuFrameProfile* collect(uint32_t slot);
+
+    // Stats over the last STATS_WINDOW samples of every scope.
+    std::map<std::string, GpuScopeStats> stats() const;
+    void                                 print_stats(std::ostream& out) const;
+
+    uint64_t missed() const { return m_missed; }
+
+   private:
+    void write_trace(const GpuFrameProfile& profile);
+};
+
+}  // namespace renderer
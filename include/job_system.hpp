@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace renderer {
+
+// Fixed pool of worker threads for fork/join parallelism. dispatch() hands out job indices from a shared
+// counter, so uneven jobs balance themselves; the calling thread works along as worker 0.
+class JobSystem {
+   public:
+    using Job = std::function<void(uint32_t job_index, uint32_t worker_index)>;
+
+   private:
+    std::vector<std::thread> m_threads = {};
+
+    std::mutex              m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    const Job*            m_job             = nullptr;
+    uint32_t              m_job_count       = 0;
+    std::atomic<uint32_t> m_next_job        = 0;
+    uint32_t              m_pending_workers = 0;
+    uint64_t              m_generation      = 0;
+    bool                  m_stopping        = false;
+    std::exception_ptr    m_exception       = nullptr;
+
+   public:
+    // worker_count includes the calling thread, so 1 runs every job inline.
+    void init(uint32_t worker_count);
+    void cleanup();
+
+    uint32_t worker_count() const { return static_cast<uint32_t>(m_threads.size()) + 1; }
+
+    // Runs job(i, worker) for every i in [0, job_count) and returns once all of them finished. The first
+    // exception thrown by a job is rethrown here.
+    void dispatch(uint32_t job_count, const Job& job);
+
+   private:
+    void worker_main(uint32_t worker_index);
+    void run_jobs(uint32_t worker_index);
+};
+
+}  // namespace renderer
@@ -1,5 +1,14 @@
 #pragma once
 
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+// Column-major, right-handed math types laid out like their GLSL counterparts. Vec4, Quat, Mat3 and Mat4 are 16-byte
+// aligned and can be copied straight into std140/std430 blocks; Vec2/Vec3 stay tightly packed for vertex attributes,
+// so a vec3 member of a uniform block still needs its own alignas(16). Everything that does not need sqrt or
+// trigonometry is constexpr.
 namespace math {
 struct Vec2 {
     float x{}, y{};
@@ -9,7 +18,7 @@ struct Vec3 {
     float x{}, y{}, z{};
 };
 
-struct Vec4 {
+struct alignas(16) Vec4 {
     float x{}, y{}, z{}, w{};
 };
 
@@ -24,4 +33,274 @@ struct DVec3 {
 struct DVec4 {
     double x{}, y{}, z{}, w{};
 };
+
+// Unit quaternion (x, y, z) * sin(angle / 2) + w * cos(angle / 2).
+struct alignas(16) Quat {
+    float x{}, y{}, z{}, w{1.0f};
+};
+
+// std140/std430 mat3: three columns, each padded to a vec4.
+struct alignas(16) Mat3 {
+    Vec4 columns[3]{{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}};
+};
+
+struct alignas(16) Mat4 {
+    Vec4 columns[4]{
+        {1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}};
+};
+
+static_assert(sizeof(Vec3) == 12 && sizeof(Vec4) == 16 && alignof(Vec4) == 16);
+static_assert(sizeof(Mat3) == 48 && sizeof(Mat4) == 64 && alignof(Mat4) == 16);
+
+/* ---- Vectors ---- */
+
+constexpr Vec3 operator+(Vec3 a, Vec3 b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+constexpr Vec3 operator-(Vec3 a, Vec3 b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+constexpr Vec3 operator-(Vec3 a) { return {-a.x, -a.y, -a.z}; }
+constexpr Vec3 operator*(Vec3 a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+constexpr Vec3 operator*(float s, Vec3 a) { return a * s; }
+
+constexpr Vec4 operator+(Vec4 a, Vec4 b) { return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w}; }
+constexpr Vec4 operator-(Vec4 a, Vec4 b) { return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w}; }
+constexpr Vec4 operator*(Vec4 a, float s) { return {a.x * s, a.y * s, a.z * s, a.w * s}; }
+constexpr Vec4 operator*(float s, Vec4 a) { return a * s; }
+
+constexpr float dot(Vec3 a, Vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+constexpr float dot(Vec4 a, Vec4 b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+constexpr Vec3  cross(Vec3 a, Vec3 b) { return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+
+inline float length(Vec3 a) { return std::sqrt(dot(a, a)); }
+inline Vec3  normalize(Vec3 a) { return a * (1.0f / length(a)); }
+
+/* ---- Quaternions ---- */
+
+constexpr Quat operator*(Quat a, Quat b) {
+    return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y, a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w, a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+}
+
+constexpr Quat conjugate(Quat q) { return {-q.x, -q.y, -q.z, q.w}; }
+
+// q * v * conjugate(q), expanded so it costs two cross products instead of two quaternion products.
+constexpr Vec3 rotate(Quat q, Vec3 v) {
+    Vec3 axis{q.x, q.y, q.z};
+    Vec3 t = cross(axis, v) * 2.0f;
+    return v + t * q.w + cross(axis, t);
+}
+
+inline Quat normalize(Quat q) {
+    float inverse_length = 1.0f / std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    return {q.x * inverse_length, q.y * inverse_length, q.z * inverse_length, q.w * inverse_length};
+}
+
+// axis must be normalized; angle in radians.
+inline Quat axis_angle(Vec3 axis, float angle) {
+    float s = std::sin(angle * 0.5f);
+    return {axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f)};
+}
+
+// Spherical interpolation along the shorter arc; falls back to normalized lerp for nearly equal rotations.
+inline Quat slerp(Quat a, Quat b, float t) {
+    float cos_theta = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    if (cos_theta < 0.0f) {
+        b         = {-b.x, -b.y, -b.z, -b.w};
+        cos_theta = -cos_theta;
+    }
+
+    float wa = 1.0f - t;
+    float wb = t;
+    if (cos_theta < 0.9995f) {
+        float theta     = std::acos(cos_theta);
+        float sin_theta = std::sin(theta);
+        wa              = std::sin(wa * theta) / sin_theta;
+        wb              = std::sin(wb * theta) / sin_theta;
+    }
+
+    return normalize(Quat{wa * a.x + wb * b.x, wa * a.y + wb * b.y, wa * a.z + wb * b.z, wa * a.w + wb * b.w});
+}
+
+/* ---- Matrices ---- */
+
+constexpr Vec4 operator*(const Mat4& m, Vec4 v) {
+    return m.columns[0] * v.x + m.columns[1] * v.y + m.columns[2] * v.z + m.columns[3] * v.w;
+}
+
+constexpr Mat4 operator*(const Mat4& a, const Mat4& b) {
+    Mat4 result;
+    for (int i = 0; i < 4; ++i) {
+        result.columns[i] = a * b.columns[i];
+    }
+    return result;
+}
+
+constexpr Vec3 operator*(const Mat3& m, Vec3 v) {
+    Vec4 r = m.columns[0] * v.x + m.columns[1] * v.y + m.columns[2] * v.z;
+    return {r.x, r.y, r.z};
+}
+
+constexpr Mat3 operator*(const Mat3& a, const Mat3& b) {
+    Mat3 result;
+    for (int i = 0; i < 3; ++i) {
+        Vec3 column       = a * Vec3{b.columns[i].x, b.columns[i].y, b.columns[i].z};
+        result.columns[i] = {column.x, column.y, column.z, 0.0f};
+    }
+    return result;
+}
+
+constexpr Mat4 transpose(const Mat4& m) {
+    Mat4 result;
+    result.columns[0] = {m.columns[0].x, m.columns[1].x, m.columns[2].x, m.columns[3].x};
+    result.columns[1] = {m.columns[0].y, m.columns[1].y, m.columns[2].y, m.columns[3].y};
+    result.columns[2] = {m.columns[0].z, m.columns[1].z, m.columns[2].z, m.columns[3].z};
+    result.columns[3] = {m.columns[0].w, m.columns[1].w, m.columns[2].w, m.columns[3].w};
+    return result;
+}
+
+constexpr Mat3 transpose(const Mat3& m) {
+    Mat3 result;
+    result.columns[0] = {m.columns[0].x, m.columns[1].x, m.columns[2].x, 0.0f};
+    result.columns[1] = {m.columns[0].y, m.columns[1].y, m.columns[2].y, 0.0f};
+    result.columns[2] = {m.columns[0].z, m.columns[1].z, m.columns[2].z, 0.0f};
+    return result;
+}
+
+// Upper-left 3x3 block, i.e. the rotation and scale of an affine transform.
+constexpr Mat3 to_mat3(const Mat4& m) {
+    Mat3 result;
+    for (int i = 0; i < 3; ++i) {
+        result.columns[i] = {m.columns[i].x, m.columns[i].y, m.columns[i].z, 0.0f};
+    }
+    return result;
+}
+
+constexpr Mat3 to_mat3(Quat q) {
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    Mat3 result;
+    result.columns[0] = {1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f};
+    result.columns[1] = {2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f};
+    result.columns[2] = {2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f};
+    return result;
+}
+
+constexpr Mat4 translation(Vec3 t) {
+    Mat4 result;
+    result.columns[3] = {t.x, t.y, t.z, 1.0f};
+    return result;
+}
+
+constexpr Mat4 scaling(Vec3 s) {
+    Mat4 result;
+    result.columns[0].x = s.x;
+    result.columns[1].y = s.y;
+    result.columns[2].z = s.z;
+    return result;
+}
+
+// translation(t) * rotation(r) * scaling(s) without the two matrix products.
+constexpr Mat4 trs(Vec3 t, Quat r, Vec3 s) {
+    Mat3 rotation = to_mat3(r);
+
+    Mat4 result;
+    result.columns[0] = rotation.columns[0] * s.x;
+    result.columns[1] = rotation.columns[1] * s.y;
+    result.columns[2] = rotation.columns[2] * s.z;
+    result.columns[3] = {t.x, t.y, t.z, 1.0f};
+    return result;
+}
+
+// Inverse of a matrix whose last row is (0, 0, 0, 1), by inverting the 3x3 block with its adjugate.
+constexpr Mat4 inverse_affine(const Mat4& m) {
+    Vec3 c0{m.columns[0].x, m.columns[0].y, m.columns[0].z};
+    Vec3 c1{m.columns[1].x, m.columns[1].y, m.columns[1].z};
+    Vec3 c2{m.columns[2].x, m.columns[2].y, m.columns[2].z};
+    Vec3 t{m.columns[3].x, m.columns[3].y, m.columns[3].z};
+
+    // Rows of the inverse are the cross products of the columns, divided by the determinant.
+    Vec3  r0                  = cross(c1, c2);
+    Vec3  r1                  = cross(c2, c0);
+    Vec3  r2                  = cross(c0, c1);
+    float inverse_determinant = 1.0f / dot(c0, r0);
+
+    r0 = r0 * inverse_determinant;
+    r1 = r1 * inverse_determinant;
+    r2 = r2 * inverse_determinant;
+
+    Mat4 result;
+    result.columns[0] = {r0.x, r1.x, r2.x, 0.0f};
+    result.columns[1] = {r0.y, r1.y, r2.y, 0.0f};
+    result.columns[2] = {r0.z, r1.z, r2.z, 0.0f};
+    result.columns[3] = {-dot(r0, t), -dot(r1, t), -dot(r2, t), 1.0f};
+    return result;
+}
+
+// Vulkan clip space: depth in [0, 1] and y pointing down. fov_y in radians.
+inline Mat4 perspective(float fov_y, float aspect, float near_plane, float far_plane) {
+    float focal = 1.0f / std::tan(fov_y * 0.5f);
+
+    Mat4 result;
+    result.columns[0] = {focal / aspect, 0.0f, 0.0f, 0.0f};
+    result.columns[1] = {0.0f, -focal, 0.0f, 0.0f};
+    result.columns[2] = {0.0f, 0.0f, far_plane / (near_plane - far_plane), -1.0f};
+    result.columns[3] = {0.0f, 0.0f, near_plane * far_plane / (near_plane - far_plane), 0.0f};
+    return result;
+}
+
+inline Mat4 look_at(Vec3 eye, Vec3 target, Vec3 up) {
+    Vec3 forward = normalize(target - eye);
+    Vec3 right   = normalize(cross(forward, up));
+    Vec3 true_up = cross(right, forward);
+
+    Mat4 result;
+    result.columns[0] = {right.x, true_up.x, -forward.x, 0.0f};
+    result.columns[1] = {right.y, true_up.y, -forward.y, 0.0f};
+    result.columns[2] = {right.z, true_up.z, -forward.z, 0.0f};
+    result.columns[3] = {-dot(right, eye), -dot(true_up, eye), dot(forward, eye), 1.0f};
+    return result;
+}
+
+// Left, right, top, bottom, near and far planes of the view volume of a Vulkan clip-space view_projection, as
+// (normal, distance) with the normal pointing inwards: a point p is inside every plane when dot(n, p) + d >= 0.
+inline std::array<Vec4, 6> frustum_planes(const Mat4& view_projection) {
+    auto row = [&view_projection](int i) {
+        auto component = [i](Vec4 v) { return i == 0 ? v.x : i == 1 ? v.y : i == 2 ? v.z : v.w; };
+
+        const Mat4& m = view_projection;
+        return Vec4{component(m.columns[0]), component(m.columns[1]), component(m.columns[2]), component(m.columns[3])};
+    };
+
+    // Gribb/Hartmann: -w <= x <= w, -w <= y <= w and 0 <= z <= w in clip space.
+    std::array<Vec4, 6> planes = {row(3) + row(0), row(3) - row(0), row(3) + row(1),
+                                  row(3) - row(1), row(2),          row(3) - row(2)};
+
+    for (Vec4& plane : planes) {
+        plane = plane * (1.0f / length(Vec3{plane.x, plane.y, plane.z}));
+    }
+    return planes;
+}
+
+/* ---- Batch kernels (lib/math.cpp) ---- */
+
+// Instruction set the batch kernels were compiled for: "avx2", "sse", "neon" or "scalar". It is picked at compile
+// time from the target flags, e.g. make CXXARCH=-march=native.
+const char* simd_path();
+
+// out[i] = m * in[i]
+void transform(const Mat4& m, std::span<const Vec4> in, std::span<Vec4> out);
+
+// out[i] = a[i] * b[i]
+void multiply(std::span<const Mat4> a, std::span<const Mat4> b, std::span<Mat4> out);
+
+// out[i] = a * b[i], e.g. a parent transform applied to many children.
+void multiply(const Mat4& a, std::span<const Mat4> b, std::span<Mat4> out);
+
+// The same kernels built from the constexpr operators above, as a baseline for the SIMD paths.
+namespace scalar {
+void transform(const Mat4& m, std::span<const Vec4> in, std::span<Vec4> out);
+void multiply(std::span<const Mat4> a, std::span<const Mat4> b, std::span<Mat4> out);
+void multiply(const Mat4& a, std::span<const Mat4> b, std::span<Mat4> out);
+}  // namespace scalar
+
 }  // namespace math
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "device_context.hpp"
+#include "frame_scheduler.hpp"
+#include "job_system.hpp"
+#include "pipeline.hpp"
+
+namespace renderer {
+
+// Records the contents of a render pass as secondary command buffers on every JobSystem worker. Command
+// pools are not thread-safe, so each worker owns one pool per frame in flight; a frame's pools are reset
+// wholesale once its fence has signaled.
+class ParallelRecorder {
+   public:
+    // Records draws [first_draw, first_draw + draw_count) into a secondary command buffer that continues
+    // the render pass. Called concurrently from several workers.
+    using RecordRange = std::function<void(VkCommandBuffer command_buffer, uint32_t first_draw, uint32_t draw_count)>;
+
+   private:
+    // More jobs than workers so a slow range does not leave the other workers idle.
+    static constexpr uint32_t JOBS_PER_WORKER   = 4;
+    static constexpr uint32_t MIN_DRAWS_PER_JOB = 64;
+
+    class WorkerPool {
+       public:
+        VkCommandPool                command_pool    = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> command_buffers = {};
+        uint32_t                     used            = 0;
+    };
+
+    const DeviceContext* m_context    = nullptr;
+    JobSystem*           m_job_system = nullptr;
+
+    std::array<std::vector<WorkerPool>, MAX_FRAMES_IN_FLIGHT> m_worker_pools = {};
+    std::vector<VkCommandBuffer>                               m_recorded     = {};
+
+   public:
+    void init(const DeviceContext& context, JobSystem& job_system);
+    void cleanup();
+
+    // Splits draw_count draws into ranges, records them in parallel and returns the secondary command
+    // buffers in draw order, ready for vkCmdExecuteCommands inside a render pass begun with
+    // VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. The frame's previous buffers must no longer be in use.
+    const std::vector<VkCommandBuffer>& record(uint32_t frame_index, VkRenderPass render_pass,
+                                               VkFramebuffer framebuffer, uint32_t draw_count,
+                                               const RecordRange& record_range);
+
+    // Same, for a dynamic render pass instance begun with VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT whose
+    // attachments match render_pass_layout.
+    const std::vector<VkCommandBuffer>& record(uint32_t frame_index, const RenderPassLayout& render_pass_layout,
+                                               uint32_t draw_count, const RecordRange& record_range);
+
+   private:
+    const std::vector<VkCommandBuffer>& record_inherited(uint32_t                              frame_index,
+                                                         const VkCommandBufferInheritanceInfo& inheritance_info,
+                                                         uint32_t draw_count, const RecordRange& record_range);
+
+    void            create_worker_pools();
+    void            destroy_worker_pools();
+    VkCommandBuffer acquire_command_buffer(WorkerPool& worker_pool);
+};
+
+}  // namespace renderer
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace renderer {
+
+class ShaderArchive;
+
+// Attachment formats and sample counts of a render pass. A pipeline created against one render pass may be used with
+// every render pass of the same layout: load/store ops and image layouts do not affect compatibility. With dynamic
+// rendering this is all a pipeline is created against.
+class RenderPassLayout {
+   public:
+    VkFormat              color_format = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits samples      = VK_SAMPLE_COUNT_1_BIT;
+
+    uint64_t hash() const;
+};
+
+// Everything that differs between the graphics pipelines of our apps. Viewport and scissor are always
+// dynamic, so a pipeline survives swapchain recreation.
+class GraphicsPipelineDesc {
+   public:
+    std::string vert_shader_path = "bin/shaders/shader.vert.spv";
+    std::string frag_shader_path = "bin/shaders/shader.frag.spv";
+
+    std::vector<VkVertexInputBindingDescription>   vertex_bindings   = {};
+    std::vector<VkVertexInputAttributeDescription> vertex_attributes = {};
+
+    std::vector<VkDescriptorSetLayout> set_layouts          = {};
+    std::vector<VkPushConstantRange>   push_constant_ranges = {};
+
+    VkPrimitiveTopology topology     = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPolygonMode       polygon_mode = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags     cull_mode    = VK_CULL_MODE_BACK_BIT;
+    VkFrontFace         front_face   = VK_FRONT_FACE_CLOCKWISE;
+    bool                blend_enable = false;  // src alpha over dst: src * a + dst * (1 - a)
+
+    // FNV-1a over every field, in a fixed order, so equal descriptions always hash alike within a run (set layouts
+    // are hashed by handle). layout_hash() only covers what goes into the VkPipelineLayout.
+    uint64_t hash() const;
+    uint64_t layout_hash() const;
+};
+
+class GraphicsPipeline {
+   public:
+    VkPipelineLayout layout   = VK_NULL_HANDLE;
+    VkPipeline       pipeline = VK_NULL_HANDLE;
+};
+
+// A compute shader plus the resources it is bound with; there is no fixed-function state to describe.
+class ComputePipelineDesc {
+   public:
+    std::string shader_path = {};
+
+    std::vector<VkDescriptorSetLayout> set_layouts          = {};
+    std::vector<VkPushConstantRange>   push_constant_ranges = {};
+};
+
+class ComputePipeline {
+   public:
+    VkPipelineLayout layout   = VK_NULL_HANDLE;
+    VkPipeline       pipeline = VK_NULL_HANDLE;
+};
+
+// Single color attachment render pass; the attachment ends up in final_layout (present or transfer source).
+VkRenderPass create_render_pass(VkDevice device, VkFormat format, VkImageLayout final_layout);
+
+VkPipelineLayout create_pipeline_layout(VkDevice device, const std::vector<VkDescriptorSetLayout>& set_layouts,
+                                        const std::vector<VkPushConstantRange>& push_constant_ranges);
+
+// Pass the application's PipelineCache handle so warm launches skip shader compilation. Shader paths are looked up in
+// shader_archive when one is given (see ShaderArchive::load), else the files are mapped.
+GraphicsPipeline create_graphics_pipeline(VkDevice device, VkRenderPass render_pass, const GraphicsPipelineDesc& desc,
+                                          VkPipelineCache      pipeline_cache = VK_NULL_HANDLE,
+                                          const ShaderArchive* shader_archive = nullptr);
+void             destroy_graphics_pipeline(VkDevice device, GraphicsPipeline& pipeline);
+
+// Same, but with a layout the caller owns (e.g. shared between pipelines); only the VkPipeline is created. A null
+// render_pass creates the pipeline for dynamic rendering into attachments matching render_pass_layout.
+VkPipeline create_graphics_pipeline(VkDevice device, VkRenderPass render_pass,
+                                    const RenderPassLayout& render_pass_layout, const GraphicsPipelineDesc& desc,
+                                    VkPipelineLayout layout, VkPipelineCache pipeline_cache = VK_NULL_HANDLE,
+                                    const ShaderArchive* shader_archive = nullptr);
+
+ComputePipeline create_compute_pipeline(VkDevice device, const ComputePipelineDesc& desc,
+                                        VkPipelineCache      pipeline_cache = VK_NULL_HANDLE,
+                                        const ShaderArchive* shader_archive = nullptr);
+void            destroy_compute_pipeline(VkDevice device, ComputePipeline& pipeline);
+
+}  // namespace renderer
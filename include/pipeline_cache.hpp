@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "device_context.hpp"
+
+namespace renderer {
+
+// VkPipelineCache persisted between launches. The file is keyed by vendorID, deviceID, driverVersion and
+// pipelineCacheUUID; a file written by another device or driver, or a truncated/corrupt one, is ignored
+// and the cache starts empty.
+class PipelineCache {
+   private:
+    static constexpr uint32_t FILE_MAGIC   = 0x48435050;  // "PPCH"
+    static constexpr uint32_t FILE_VERSION = 1;
+
+    // Prepended to the driver's cache blob, which itself only carries vendor, device and UUID.
+    class FileHeader {
+       public:
+        uint32_t magic                    = FILE_MAGIC;
+        uint32_t version                  = FILE_VERSION;
+        uint32_t vendor_id                = 0;
+        uint32_t device_id                = 0;
+        uint32_t driver_version           = 0;
+        uint8_t  cache_uuid[VK_UUID_SIZE] = {};
+        uint64_t data_size                = 0;
+        uint64_t data_hash                = 0;
+    };
+
+    const DeviceContext* m_context     = nullptr;
+    VkPipelineCache      m_cache       = VK_NULL_HANDLE;
+    std::string          m_path        = {};
+    FileHeader           m_expected    = {};
+    size_t               m_loaded_size = 0;
+
+   public:
+    // Loads <directory>/<name>-<vendor>-<device>-<driver>.pcache if it exists and matches this device.
+    void init(const DeviceContext& context, const std::string& directory, const std::string& name);
+
+    // Writes the cache back (temporary file + rename, so a crash never leaves a half-written cache) and
+    // destroys it. Pipelines created from it stay valid.
+    void cleanup();
+
+    VkPipelineCache    handle() const { return m_cache; }
+    const std::string& path() const { return m_path; }
+
+    // True if a valid cache file was found, i.e. this is a warm start.
+    bool   warm() const { return m_loaded_size > 0; }
+    size_t loaded_size() const { return m_loaded_size; }
+
+   private:
+    std::vector<std::byte> load_file() const;
+    void                   save_file(const std::vector<std::byte>& data) const;
+    bool                   validate(const FileHeader& header, const std::vector<std::byte>& data) const;
+};
+
+}  // namespace renderer
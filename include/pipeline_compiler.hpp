@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "pipeline.hpp"
+#include "pipeline_state_cache.hpp"
+
+namespace renderer {
+
+class PipelineCompilerStats {
+   public:
+    uint64_t requested        = 0;
+    uint64_t compiled         = 0;
+    uint64_t failed           = 0;
+    double   total_latency_ms = 0.0;  // request to publish, summed over compiled pipelines
+    double   max_latency_ms   = 0.0;
+};
+
+// Compiles graphics pipelines on worker threads so that a new variant never stalls the render thread. request()
+// queues a description and returns its PipelineStateCache key right away; the renderer looks the key up every frame
+// and draws with a fallback (or skips the draw) until the pipeline is published, which happens atomically through
+// the state cache once the worker finished vkCreateGraphicsPipelines.
+class PipelineCompiler {
+   private:
+    class Request {
+       public:
+        uint64_t                              key = 0;
+        GraphicsPipelineDesc                  desc;
+        RenderPassLayout                      render_pass_layout;
+        std::chrono::steady_clock::time_point requested;
+    };
+
+    PipelineStateCache* m_pipeline_states = nullptr;
+
+    std::vector<std::thread> m_threads = {};
+
+    std::mutex                   m_mutex;
+    std::condition_variable      m_wake;
+    std::condition_variable      m_idle;
+    std::deque<Request>          m_queue;
+    std::unordered_set<uint64_t> m_pending;  // queued or being compiled
+    std::unordered_set<uint64_t> m_failed;   // never requeued
+    uint32_t                     m_active   = 0;
+    bool                         m_stopping = false;
+    PipelineCompilerStats        m_stats    = {};
+
+   public:
+    // Pipelines are created through and owned by pipeline_states, which must outlive the compiler.
+    void init(PipelineStateCache& pipeline_states, uint32_t thread_count);
+
+    // Drops the requests still queued and joins the workers once the ones being compiled are published.
+    void cleanup();
+
+    // Queues desc unless it is published, already queued or failed before. Returns the key to look it up with.
+    uint64_t request(const GraphicsPipelineDesc& desc, const RenderPassLayout& render_pass_layout);
+
+    // The pipeline for key, or one with null handles while it is still compiling. Lock-free.
+    GraphicsPipeline find(uint64_t key) const { return m_pipeline_states->find(key); }
+
+    // Blocks until every queued request has been compiled.
+    void wait_idle();
+
+    PipelineCompilerStats stats();
+
+   private:
+    void worker_main();
+};
+
+}  // namespace renderer
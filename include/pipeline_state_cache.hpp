@@ -0,0 +1,132 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "device_context.hpp"
+#include "frame_scheduler.hpp"
+#include "pipeline.hpp"
+#include "shader_archive.hpp"
+
+namespace renderer {
+
+class PipelineStateStats {
+   public:
+    uint64_t pipelines_created = 0;
+    uint64_t layouts_created   = 0;
+    uint64_t deduplicated      = 0;  // get() calls answered by a pipeline that already existed
+    double   create_ms         = 0.0;
+    uint64_t pipelines_rebuilt = 0;
+    double   rebuild_ms        = 0.0;
+    double   max_rebuild_ms    = 0.0;
+};
+
+// One pipeline recreated by PipelineStateCache::rebuild().
+class PipelineRebuild {
+   public:
+    uint64_t    key              = 0;
+    std::string vert_shader_path = {};
+    std::string frag_shader_path = {};
+    bool        rebuilt          = false;  // false if creation failed and the old pipeline was kept
+    double      rebuild_ms       = 0.0;
+};
+
+// Graphics pipelines created on demand and shared by every caller asking for the same state. Pipelines are keyed by
+// GraphicsPipelineDesc::hash() combined with the RenderPassLayout they are compatible with and, for shaders packed in
+// the ShaderArchive, the hash of their code, so a rebuilt shader never resolves to a stale pipeline; pipeline layouts
+// are shared between descriptions with the same set layouts and push constant ranges.
+//
+// Lookups never lock: the key -> pipeline map is copy-on-write. A writer copies the current map under a mutex,
+// inserts into the copy and publishes it with one atomic store, so find() is an atomic load plus a hash lookup
+// and recording threads never wait on each other or on a pipeline being created. Replaced maps are kept until
+// reclaim(), since a reader may still be looking into one.
+//
+// rebuild() recreates the pipelines of a shader that changed on disk and publishes them under their old keys; the
+// pipelines they replace stay alive until the frames that may have recorded them have completed.
+class PipelineStateCache {
+   private:
+    using PipelineMap = std::unordered_map<uint64_t, GraphicsPipeline>;
+
+    class Description {
+       public:
+        GraphicsPipelineDesc desc;
+        RenderPassLayout     render_pass_layout;
+    };
+
+    class RetiredPipeline {
+       public:
+        VkPipeline pipeline     = VK_NULL_HANDLE;
+        uint64_t   retire_value = 0;  // FrameScheduler value after which no frame uses it
+    };
+
+    const DeviceContext* m_context        = nullptr;
+    VkPipelineCache      m_pipeline_cache = VK_NULL_HANDLE;
+    const ShaderArchive* m_shader_archive = nullptr;
+
+    std::atomic<const PipelineMap*>                 m_pipelines = nullptr;  // the published map
+    std::vector<std::unique_ptr<const PipelineMap>> m_maps;                 // every map not yet reclaimed
+    std::atomic<uint64_t>                           m_hits      = 0;
+
+    // Everything below is only touched with m_write_mutex held.
+    std::mutex                                     m_write_mutex;
+    std::unordered_map<uint64_t, VkPipelineLayout> m_layouts;
+    std::unordered_map<uint64_t, VkRenderPass>     m_render_passes;  // RenderPassLayout hash -> first render pass
+    std::unordered_map<uint64_t, Description>      m_descriptions;   // of every published pipeline, for rebuild()
+    std::deque<RetiredPipeline>                    m_retired;        // in increasing retire_value order
+    PipelineStateStats                             m_stats = {};
+
+   public:
+    // Shaders are loaded through shader_archive if given, which must outlive the cache.
+    void init(const DeviceContext& context, VkPipelineCache pipeline_cache = VK_NULL_HANDLE,
+              const ShaderArchive* shader_archive = nullptr);
+
+    // Destroys every pipeline and layout; the device must be idle.
+    void cleanup();
+
+    // Pipelines for render_pass_layout are created against render_pass, which must outlive the cache. Only the
+    // first render pass registered for a layout is used, later ones are compatible with it. A null render pass
+    // registers the layout for dynamic rendering.
+    void add_render_pass(const RenderPassLayout& render_pass_layout, VkRenderPass render_pass);
+
+    uint64_t key(const GraphicsPipelineDesc& desc, const RenderPassLayout& render_pass_layout) const;
+
+    // The published pipeline for key, or one with null handles if it has not been created. Lock-free and safe to
+    // call from any thread.
+    GraphicsPipeline find(uint64_t key) const;
+
+    // Returns the pipeline for desc, creating and publishing it on first use. Creation runs outside the lock, so
+    // several threads can compile different pipelines at once; if two create the same one, the first to publish wins.
+    GraphicsPipeline get(const GraphicsPipelineDesc& desc, const RenderPassLayout& render_pass_layout);
+
+    // get() without the lock-free lookup, so it may run on a thread that is not synchronized with reclaim().
+    GraphicsPipeline create(const GraphicsPipelineDesc& desc, const RenderPassLayout& render_pass_layout);
+
+    // Recreates every published pipeline whose vertex or fragment shader is shader_path (matched by shader_name())
+    // and swaps the new ones in at once, so the next find() returns them. The pipelines replaced are retired against
+    // retire_value and destroyed by reclaim() once frame_scheduler reports it complete. A pipeline that fails to
+    // build keeps its old version. Call between frames, like reclaim().
+    std::vector<PipelineRebuild> rebuild(std::string_view shader_path, uint64_t retire_value);
+
+    // Frees the maps replaced since the last call and the retired pipelines no frame uses anymore. No thread may be
+    // inside find() while this runs, e.g. call it between frames before recording starts.
+    void reclaim(FrameScheduler& frame_scheduler);
+
+    size_t             pipeline_count() const { return m_pipelines.load(std::memory_order_acquire)->size(); }
+    PipelineStateStats stats();
+
+   private:
+    VkPipelineLayout get_layout(const GraphicsPipelineDesc& desc);
+    VkRenderPass     get_render_pass(const RenderPassLayout& render_pass_layout);
+    GraphicsPipeline publish(uint64_t key, const GraphicsPipeline& pipeline);
+};
+
+}  // namespace renderer
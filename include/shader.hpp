@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace renderer {
+
+// A whole file mapped read-only and prefaulted. The data is page aligned and unmapped with the object.
+class MappedFile {
+   private:
+    void*  m_data = nullptr;
+    size_t m_size = 0;
+
+   public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Throws if the file cannot be opened or mapped, or is empty.
+    static MappedFile map(const std::string& path);
+
+    std::span<const std::byte> bytes() const { return {static_cast<const std::byte*>(m_data), m_size}; }
+
+   private:
+    void reset();
+};
+
+// Read-only SPIR-V code, validated on load. Files are mapped with mmap rather than read, so the words come straight
+// from the page cache: page aligned (which satisfies the 4-byte alignment vkCreateShaderModule needs) and never copied
+// to the heap. The mapping lives as long as the blob; a module created from it no longer needs it.
+class ShaderBlob {
+   public:
+    static constexpr uint32_t SPIRV_MAGIC        = 0x07230203;
+    static constexpr size_t   SPIRV_HEADER_WORDS = 5;  // magic, version, generator, bound, schema
+
+   private:
+    MappedFile                m_file = {};  // empty for views
+    std::span<const uint32_t> m_code = {};
+
+   public:
+    // Throws if the file cannot be mapped or is not SPIR-V.
+    static ShaderBlob map_file(const std::string& path);
+
+    // Code owned by someone else, e.g. a section of an archive mapping; name only appears in errors.
+    static ShaderBlob view(std::span<const uint32_t> code, const std::string& name);
+
+    std::span<const uint32_t> code() const { return m_code; }
+    size_t                    size_bytes() const { return m_code.size_bytes(); }
+};
+
+// Throws unless code is a whole number of words starting with a SPIR-V header.
+void validate_spirv(std::span<const std::byte> code, const std::string& name);
+
+VkShaderModule create_shader_module(VkDevice device, std::span<const uint32_t> code);
+
+}  // namespace renderer
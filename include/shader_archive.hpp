@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shader.hpp"
+
+namespace renderer {
+
+// The name a shader is identified by wherever it is loaded from: the file name of its path.
+std::string_view shader_name(std::string_view path);
+
+// SPIR-V compiled into the binary by an EMBED_SHADERS=1 build (see tools/shader_embed), looked up by shader_name().
+// Empty if path is not embedded, which is always the case in a regular build.
+std::span<const uint32_t> find_embedded_shader(std::string_view path);
+size_t                    embedded_shader_count();
+
+// On-disk layout of a shader archive, in host byte order. Both hashes are 64-bit FNV-1a.
+//
+//   ShaderArchiveHeader
+//   ShaderArchiveEntry[entry_count]  sorted by name_hash, then name
+//   names                            names_size bytes, each name NUL-terminated
+//   code                             each blob starts at a multiple of ShaderArchive::CODE_ALIGNMENT
+class ShaderArchiveHeader {
+   public:
+    uint32_t magic       = 0;
+    uint32_t version     = 0;
+    uint32_t entry_count = 0;
+    uint32_t names_size  = 0;
+};
+
+class ShaderArchiveEntry {
+   public:
+    uint64_t name_hash    = 0;
+    uint64_t content_hash = 0;  // of the code
+    uint64_t offset       = 0;  // of the code, from the start of the archive
+    uint32_t size         = 0;  // of the code, in bytes
+    uint32_t name_offset  = 0;  // into the names
+};
+
+static_assert(sizeof(ShaderArchiveHeader) == 16);
+static_assert(sizeof(ShaderArchiveEntry) == 32);
+
+// Every SPIR-V file of a build packed into one file (see tools/shader_pack), mapped once and looked up by binary
+// search over the index, so loading a shader is neither an open() nor a copy. Shaders are named by file name only:
+// "bin/shaders/shader.vert.spv" finds "shader.vert.spv", which is how pipeline descriptions keep their paths while
+// no longer depending on the working directory. load() falls back to the file itself for shaders not in the archive
+// and when no archive was found.
+class ShaderArchive {
+   public:
+    static constexpr uint32_t MAGIC          = 0x4b415053;  // "SPAK"
+    static constexpr uint32_t VERSION        = 1;
+    static constexpr size_t   CODE_ALIGNMENT = 16;
+
+   private:
+    std::string                         m_path    = {};
+    MappedFile                          m_file    = {};
+    std::span<const ShaderArchiveEntry> m_entries = {};
+    std::string_view                    m_names   = {};
+
+   public:
+    // Maps the archive at path. Returns false if there is no such file; throws if it is not a valid archive.
+    bool init(const std::string& path);
+    void cleanup();
+
+    bool is_open() const { return !m_entries.empty(); }
+
+    // The entry named like the file name of path, or null. O(log n) in the number of shaders, no allocation.
+    const ShaderArchiveEntry* find(std::string_view path) const;
+
+    // The code of path: a view into the archive if it is packed there, else the mapped file.
+    ShaderBlob load(const std::string& path) const;
+
+    // Hash of path's code, or 0 if the shader is not in the archive.
+    uint64_t content_hash(std::string_view path) const;
+
+    size_t             size() const { return m_entries.size(); }
+    const std::string& path() const { return m_path; }
+
+    // Packs inputs (SPIR-V files, validated on the way) into an archive at path. Throws on duplicate file names.
+    static void write(const std::string& path, const std::vector<std::string>& inputs);
+
+   private:
+    std::string_view name(const ShaderArchiveEntry& entry) const;
+};
+
+}  // namespace renderer
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace renderer {
+
+class ShaderChange {
+   public:
+    std::string spv_path   = {};  // the recompiled output
+    double      compile_ms = 0.0;
+};
+
+// Watches a directory of GLSL sources with inotify and recompiles a .vert, .frag or .comp file into the output
+// directory as soon as it has been written, on a thread of its own. Bursts of events (editors often write a file more
+// than once) are coalesced so that every source compiles once per save. Compile errors are printed and leave the
+// previous SPIR-V in place; the render thread only hears about shaders that compiled.
+class ShaderWatcher {
+   private:
+    static constexpr int SETTLE_MS = 50;  // quiet time after an event before compiling
+
+    std::string m_source_directory = {};
+    std::string m_output_directory = {};
+    std::string m_compiler         = {};
+
+    int         m_inotify = -1;
+    int         m_wake    = -1;  // eventfd, signaled by cleanup()
+    std::thread m_thread  = {};
+
+    std::mutex                m_mutex;
+    std::vector<ShaderChange> m_changes;
+
+   public:
+    // Throws if source_directory cannot be watched.
+    void init(const std::string& source_directory, const std::string& output_directory,
+              const std::string& compiler = "glslc");
+    void cleanup();
+
+    // The shaders recompiled since the last call, oldest first.
+    std::vector<ShaderChange> take_changes();
+
+   private:
+    void watch_main();
+    bool compile(const std::string& source_name, ShaderChange& change) const;
+};
+
+}  // namespace renderer
@@ -0,0 +1,14 @@
+#pragma once
+
+// Instruction set used by the SIMD kernels in lib/, picked at compile time from the target flags
+// (see CXXARCH in the Makefile). Exactly one of the MATH_SIMD_* macros is defined, or none for the scalar fallback.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MATH_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MATH_SIMD_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MATH_SIMD_NEON 1
+#endif
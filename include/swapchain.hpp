@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "allocator.hpp"
+#include "device_context.hpp"
+
+namespace renderer {
+
+// Owns the presentable images and their views. In offscreen mode the images are plain device-local
+// VkImages owned by the swapchain itself: acquiring hands them out round-robin and presenting is a no-op,
+// so the frame loop can run unchanged on machines without a display.
+class Swapchain {
+   private:
+    static constexpr VkFormat OFFSCREEN_FORMAT = VK_FORMAT_B8G8R8A8_UNORM;
+
+    const DeviceContext*        m_context                    = nullptr;
+    VkSwapchainKHR              m_swapchain                  = VK_NULL_HANDLE;
+    std::vector<VkImage>        m_images                     = {};
+    VkFormat                    m_format                     = VK_FORMAT_UNDEFINED;
+    VkExtent2D                  m_extent                     = {};
+    std::vector<VkImageView>    m_image_views                = {};
+    std::vector<VkSemaphore>    m_semaphores_render_finished = {};
+    std::vector<Allocation>     m_offscreen_image_memory     = {};
+    bool                        m_offscreen                  = false;
+    uint32_t                    m_next_offscreen_image       = 0;
+
+   public:
+    void init(const DeviceContext& context);
+    void init_offscreen(const DeviceContext& context, VkExtent2D extent, uint32_t image_count);
+    void cleanup();
+
+    // Waits for a non-zero framebuffer size and the device to go idle, then rebuilds the images.
+    void recreate();
+
+    VkResult acquire_next_image(VkSemaphore image_available_semaphore, uint32_t* image_index);
+    VkResult present(VkQueue present_queue, uint32_t image_index);
+
+    bool          is_offscreen() const { return m_offscreen; }
+    VkFormat      format() const { return m_format; }
+    VkExtent2D    extent() const { return m_extent; }
+    uint32_t      image_count() const { return static_cast<uint32_t>(m_images.size()); }
+    VkImage       image(uint32_t index) const { return m_images[index]; }
+    VkImageView   image_view(uint32_t index) const { return m_image_views[index]; }
+    VkImageLayout final_layout() const;
+
+    // One render-finished semaphore per image, so a semaphore is never reused while its image is presented.
+    VkSemaphore render_finished_semaphore(uint32_t index) const { return m_semaphores_render_finished[index]; }
+
+   private:
+    void create_swapchain();
+    void create_offscreen_images(uint32_t image_count);
+    void create_image_views();
+    void create_render_finished_semaphores();
+
+    VkSurfaceFormatKHR choose_swapchain_surface_format(const std::vector<VkSurfaceFormatKHR>& formats);
+    VkPresentModeKHR   choose_swapchain_present_mode(const std::vector<VkPresentModeKHR>& present_modes);
+    VkExtent2D         choose_swapchain_extent(const VkSurfaceCapabilitiesKHR& capabilities);
+};
+
+}  // namespace renderer
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+
+#include "math.hpp"
+
+namespace math {
+
+// Array-of-structs transform, the natural layout for a single object and for editing.
+struct Transform {
+    Vec3 position{};
+    Quat rotation{};
+    Vec3 scale{1.0f, 1.0f, 1.0f};
+};
+
+enum class TransformStream : uint32_t {
+    PositionX,
+    PositionY,
+    PositionZ,
+    RotationX,
+    RotationY,
+    RotationZ,
+    RotationW,
+    ScaleX,
+    ScaleY,
+    ScaleZ,
+    Count,
+};
+
+// Structure-of-arrays transform storage: one float stream per component, every stream 64-byte aligned and padded to
+// a whole number of cache lines, so a SIMD kernel loads 4/8 instances of one component with a single load and no
+// lane is spent on padding or on components it does not need.
+class TransformSoA {
+   public:
+    static constexpr size_t ALIGNMENT       = 64;
+    static constexpr size_t STREAM_COUNT    = static_cast<size_t>(TransformStream::Count);
+    static constexpr size_t FLOATS_PER_LINE = ALIGNMENT / sizeof(float);
+
+   private:
+    class AlignedDelete {
+       public:
+        void operator()(float* data) const { ::operator delete[](data, std::align_val_t{ALIGNMENT}); }
+    };
+
+    std::unique_ptr<float[], AlignedDelete> m_data     = nullptr;
+    size_t                                  m_size     = 0;
+    size_t                                  m_capacity = 0;  // per stream, a multiple of FLOATS_PER_LINE
+
+   public:
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+
+    void reserve(size_t capacity);
+    // New transforms are identities.
+    void resize(size_t size);
+    void push_back(const Transform& transform);
+    void clear() { m_size = 0; }
+
+    void      set(size_t index, const Transform& transform);
+    Transform get(size_t index) const;
+
+    float*       stream(TransformStream stream) { return m_data.get() + static_cast<size_t>(stream) * m_capacity; }
+    const float* stream(TransformStream stream) const {
+        return m_data.get() + static_cast<size_t>(stream) * m_capacity;
+    }
+};
+
+// world[i] = trs(position, rotation, scale) of transforms [first, first + out.size()). out may point straight into a
+// persistently mapped instance buffer: it is only ever written, front to back, so write-combined memory is fine.
+void compute_world_matrices(const TransformSoA& transforms, size_t first, std::span<Mat4> out);
+
+// The same for array-of-structs input, one transform at a time.
+void compute_world_matrices(std::span<const Transform> transforms, std::span<Mat4> out);
+
+namespace scalar {
+void compute_world_matrices(const TransformSoA& transforms, size_t first, std::span<Mat4> out);
+}  // namespace scalar
+
+}  // namespace math
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "buffer.hpp"
+#include "device_context.hpp"
+#include "frame_scheduler.hpp"
+
+namespace renderer {
+
+class UploadSchedulerStats {
+   public:
+    uint64_t uploads    = 0;
+    uint64_t bytes      = 0;
+    uint64_t batches    = 0;    // command buffers submitted
+    uint64_t host_waits = 0;    // times the host blocked on a batch that was still in flight
+    double   wait_ms    = 0.0;  // CPU time spent in those waits
+};
+
+// Non-blocking copies into DEVICE_LOCAL buffers. upload() writes the data into one region of a persistently mapped
+// staging buffer and records the copy into that region's batch; flush() submits the batch on the transfer queue,
+// releasing the written ranges to the graphics queue family and signaling a timeline semaphore. acquire() then
+// records the matching acquire barriers in a frame's command buffer and makes the frame's submit wait for the
+// semaphore, so neither side ever waits on the host. The host only blocks once every batch is still in flight.
+//
+// Devices without a family separate from graphics, or without timeline semaphores, get the same batching on the
+// graphics queue: submission order already puts the copies before the frame, so acquire() is a plain barrier.
+class UploadScheduler {
+   public:
+    static constexpr VkDeviceSize DEFAULT_BATCH_SIZE = 16 * 1024 * 1024;
+
+   private:
+    static constexpr uint32_t     BATCH_COUNT    = 3;
+    static constexpr VkDeviceSize COPY_ALIGNMENT = 16;
+
+    class BufferRange {
+       public:
+        VkBuffer     buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size   = 0;
+    };
+
+    class Batch {
+       public:
+        VkCommandBuffer          command_buffer = VK_NULL_HANDLE;
+        VkFence                  fence          = VK_NULL_HANDLE;  // guards the batch's staging region
+        VkDeviceSize             used           = 0;               // bytes of the staging region written
+        bool                     recording      = false;
+        bool                     in_flight      = false;
+        std::vector<BufferRange> ranges;                           // destination ranges written by the batch
+    };
+
+    const DeviceContext* m_context         = nullptr;
+    VkQueue              m_queue           = VK_NULL_HANDLE;
+    uint32_t             m_queue_family    = 0;
+    uint32_t             m_graphics_family = 0;
+    bool                 m_async           = false;  // on a separate queue family, ordered by m_timeline
+    VkCommandPool        m_command_pool    = VK_NULL_HANDLE;
+    Buffer               m_staging_buffer  = {};     // BATCH_COUNT regions of m_batch_size bytes
+    VkDeviceSize         m_batch_size      = 0;
+
+    std::array<Batch, BATCH_COUNT> m_batches       = {};
+    uint32_t                       m_current_batch = 0;
+
+    VkSemaphore m_timeline        = VK_NULL_HANDLE;  // async only, signaled with the number of batches submitted
+    uint64_t    m_submitted_value = 0;
+
+    // Ranges of submitted batches that no frame has acquired yet.
+    std::vector<BufferRange> m_pending_acquires;
+
+    UploadSchedulerStats m_stats = {};
+
+   public:
+    // allow_async = false submits on the graphics queue even when a separate transfer family exists.
+    void init(const DeviceContext& context, bool allow_async = true, VkDeviceSize batch_size = DEFAULT_BATCH_SIZE);
+    void cleanup();
+
+    // Copies data into staging memory and records its copy into dst_buffer at dst_offset; data may be reused as soon
+    // as this returns. dst_buffer needs TRANSFER_DST usage and must not be read by the GPU before a frame has
+    // acquire()d the upload. Uploads larger than a batch are split over several.
+    void upload(VkBuffer dst_buffer, VkDeviceSize dst_offset, const void* data, VkDeviceSize size);
+
+    // Submits the batch being recorded, if any.
+    void flush();
+
+    // Makes every flushed upload visible to the commands recorded after this call in command_buffer, a graphics queue
+    // command buffer outside a render pass, and makes frame_scheduler's next submit wait for the copies.
+    void acquire(VkCommandBuffer command_buffer, FrameScheduler& frame_scheduler);
+
+    bool                        async() const { return m_async; }
+    uint32_t                    queue_family() const { return m_queue_family; }
+    const UploadSchedulerStats& stats() const { return m_stats; }
+
+   private:
+    Batch& open_batch();
+    void   record_release_barriers(const Batch& batch);
+};
+
+}  // namespace renderer
@@ -0,0 +1,421 @@
+#include "allocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace renderer {
+
+namespace {
+
+VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+/* ---- Memory backends ---- */
+
+VkResult VulkanMemoryBackend::allocate(uint32_t memory_type, VkDeviceSize size, VkDeviceMemory* memory) {
+    VkMemoryAllocateInfo memory_allocate_info{};
+    memory_allocate_info.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memory_allocate_info.allocationSize  = size;
+    memory_allocate_info.memoryTypeIndex = memory_type;
+
+    return vkAllocateMemory(m_device, &memory_allocate_info, nullptr, memory);
+}
+
+void VulkanMemoryBackend::free(VkDeviceMemory memory) {
+    vkFreeMemory(m_device, memory, nullptr);
+}
+
+VkResult VulkanMemoryBackend::map(VkDeviceMemory memory, VkDeviceSize size, void** data) {
+    return vkMapMemory(m_device, memory, 0, size, 0, data);
+}
+
+VkResult MockMemoryBackend::allocate(uint32_t memory_type, VkDeviceSize size, VkDeviceMemory* memory) {
+    (void)memory_type;
+
+    ++allocate_calls;
+
+    if (m_allocations.size() >= m_max_allocation_count) {
+        return VK_ERROR_TOO_MANY_OBJECTS;
+    }
+
+    // Non-dispatchable handles are opaque to the allocator, any unique non-null value will do.
+    *memory = (VkDeviceMemory)(m_next_handle++);
+    m_allocations.emplace(*memory, std::make_unique_for_overwrite<std::byte[]>(static_cast<size_t>(size)));
+
+    return VK_SUCCESS;
+}
+
+void MockMemoryBackend::free(VkDeviceMemory memory) {
+    ++free_calls;
+    m_allocations.erase(memory);
+}
+
+VkResult MockMemoryBackend::map(VkDeviceMemory memory, VkDeviceSize size, void** data) {
+    (void)size;
+
+    auto it = m_allocations.find(memory);
+    if (it == m_allocations.end()) {
+        return VK_ERROR_MEMORY_MAP_FAILED;
+    }
+
+    *data = it->second.get();
+    return VK_SUCCESS;
+}
+
+/* ---- Offset allocators ---- */
+
+void BuddyAllocator::init(VkDeviceSize min_size, uint32_t max_order) {
+    m_min_size  = min_size;
+    m_max_order = max_order;
+    m_used      = 0;
+
+    m_free_lists.assign(max_order + 1, {});
+    m_free_lists[max_order].insert(0);
+}
+
+uint32_t BuddyAllocator::order_for(VkDeviceSize size, VkDeviceSize alignment) const {
+    VkDeviceSize node = std::bit_ceil(std::max({size, alignment, m_min_size}));
+    return static_cast<uint32_t>(std::countr_zero(node / m_min_size));
+}
+
+std::optional<VkDeviceSize> BuddyAllocator::allocate(uint32_t order) {
+    if (order > m_max_order) {
+        return std::nullopt;
+    }
+
+    // Find the smallest free node that fits, then split it down to the requested order.
+    uint32_t current = order;
+    while (current <= m_max_order && m_free_lists[current].empty()) {
+        ++current;
+    }
+
+    if (current > m_max_order) {
+        return std::nullopt;
+    }
+
+    VkDeviceSize offset = *m_free_lists[current].begin();
+    m_free_lists[current].erase(m_free_lists[current].begin());
+
+    while (current > order) {
+        --current;
+        m_free_lists[current].insert(offset + node_size(current));
+    }
+
+    m_used += node_size(order);
+    return offset;
+}
+
+void BuddyAllocator::free(VkDeviceSize offset, uint32_t order) {
+    m_used -= node_size(order);
+
+    // Merge with the buddy for as long as it is free as well.
+    while (order < m_max_order) {
+        VkDeviceSize buddy = offset ^ node_size(order);
+
+        auto it = m_free_lists[order].find(buddy);
+        if (it == m_free_lists[order].end()) {
+            break;
+        }
+
+        m_free_lists[order].erase(it);
+        offset = std::min(offset, buddy);
+        ++order;
+    }
+
+    m_free_lists[order].insert(offset);
+}
+
+VkDeviceSize BuddyAllocator::largest_free() const {
+    for (uint32_t order = m_max_order + 1; order-- > 0;) {
+        if (!m_free_lists[order].empty()) {
+            return node_size(order);
+        }
+    }
+
+    return 0;
+}
+
+void LinearAllocator::init(VkDeviceSize size) {
+    m_size       = size;
+    m_head       = 0;
+    m_used       = 0;
+    m_live_count = 0;
+}
+
+std::optional<VkDeviceSize> LinearAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+    VkDeviceSize offset = align_up(m_head, alignment);
+    if (offset + size > m_size) {
+        return std::nullopt;
+    }
+
+    m_head = offset + size;
+    m_used += size;
+    ++m_live_count;
+
+    return offset;
+}
+
+void LinearAllocator::free(VkDeviceSize size) {
+    m_used -= size;
+
+    if (--m_live_count == 0) {
+        m_head = 0;
+    }
+}
+
+/* ---- Device allocator ---- */
+
+void DeviceAllocator::init(MemoryBackend& backend, const VkPhysicalDeviceMemoryProperties& memory_properties,
+                           VkDeviceSize buffer_image_granularity, VkDeviceSize block_size) {
+    m_backend           = &backend;
+    m_memory_properties = memory_properties;
+    m_granularity       = std::max<VkDeviceSize>(buffer_image_granularity, 1);
+    m_block_size        = std::bit_ceil(std::max(block_size, MIN_NODE_SIZE));
+}
+
+void DeviceAllocator::cleanup() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& block : m_blocks) {
+        if (block) {
+            m_backend->free(block->memory);
+        }
+    }
+
+    for (const Allocation& allocation : m_dedicated) {
+        m_backend->free(allocation.memory);
+    }
+
+    m_blocks.clear();
+    m_dedicated.clear();
+    m_bytes_requested  = 0;
+    m_allocation_count = 0;
+}
+
+Allocation DeviceAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+                                     AllocationStrategy strategy) {
+    uint32_t     memory_type = find_memory_type(requirements.memoryTypeBits, properties);
+    VkDeviceSize alignment   = std::max(requirements.alignment, m_granularity);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Allocation allocation{};
+
+    if (requirements.size > m_block_size / 2) {
+        allocation = allocate_dedicated(memory_type, requirements.size);
+    } else {
+        bool allocated = false;
+
+        for (uint32_t i = 0; i < m_blocks.size() && !allocated; ++i) {
+            MemoryBlock* block = m_blocks[i].get();
+            if (block && block->memory_type == memory_type && block->strategy == strategy &&
+                try_allocate_from(*block, requirements.size, alignment, allocation)) {
+                allocation.block_index = i;
+                allocated              = true;
+            }
+        }
+
+        if (!allocated) {
+            uint32_t     block_index = 0;
+            MemoryBlock& block       = create_block(memory_type, strategy, block_index);
+
+            if (!try_allocate_from(block, requirements.size, alignment, allocation)) {
+                throw std::runtime_error("DeviceAllocator::allocate => allocation does not fit a fresh block!");
+            }
+            allocation.block_index = block_index;
+        }
+    }
+
+    allocation.size = requirements.size;
+
+    m_bytes_requested += requirements.size;
+    ++m_allocation_count;
+
+    return allocation;
+}
+
+void DeviceAllocator::free(Allocation& allocation) {
+    if (allocation.memory == VK_NULL_HANDLE) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (allocation.block_index == Allocation::DEDICATED) {
+        m_backend->free(allocation.memory);
+        std::erase_if(m_dedicated, [&](const Allocation& dedicated) { return dedicated.memory == allocation.memory; });
+    } else {
+        MemoryBlock& block = *m_blocks[allocation.block_index];
+
+        if (block.strategy == AllocationStrategy::Buddy) {
+            block.buddy.free(allocation.offset, allocation.order);
+        } else {
+            block.linear.free(allocation.size);
+        }
+    }
+
+    m_bytes_requested -= allocation.size;
+    --m_allocation_count;
+
+    allocation = {};
+}
+
+void DeviceAllocator::trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& block : m_blocks) {
+        if (block && block->empty()) {
+            m_backend->free(block->memory);
+            block.reset();
+        }
+    }
+}
+
+uint32_t DeviceAllocator::find_memory_type(uint32_t type_filter, VkMemoryPropertyFlags properties) const {
+    for (uint32_t i = 0; i < m_memory_properties.memoryTypeCount; ++i) {
+        if ((type_filter & (1u << i)) &&
+            (m_memory_properties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("DeviceAllocator::find_memory_type => failed to find a suitable memory type!");
+}
+
+AllocatorStats DeviceAllocator::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    AllocatorStats stats{};
+    stats.bytes_requested  = m_bytes_requested;
+    stats.allocation_count = m_allocation_count;
+
+    VkDeviceSize total_free   = 0;
+    VkDeviceSize largest_free = 0;
+
+    for (const auto& block : m_blocks) {
+        if (!block) {
+            continue;
+        }
+
+        ++stats.block_count;
+        stats.bytes_reserved += block->size();
+        stats.bytes_used += block->used();
+
+        total_free += block->size() - block->used();
+        largest_free = std::max(largest_free, block->largest_free());
+    }
+
+    for (const Allocation& allocation : m_dedicated) {
+        ++stats.dedicated_count;
+        stats.bytes_reserved += allocation.size;
+        stats.bytes_used += allocation.size;
+    }
+
+    if (total_free > 0) {
+        stats.fragmentation = 1.0 - static_cast<double>(largest_free) / static_cast<double>(total_free);
+    }
+
+    return stats;
+}
+
+Allocation DeviceAllocator::allocate_dedicated(uint32_t memory_type, VkDeviceSize size) {
+    Allocation allocation{};
+    allocation.memory_type = memory_type;
+    allocation.size        = size;
+    allocation.block_index = Allocation::DEDICATED;
+
+    if (m_backend->allocate(memory_type, size, &allocation.memory) != VK_SUCCESS) {
+        throw std::runtime_error("DeviceAllocator::allocate_dedicated => failed to allocate device memory!");
+    }
+
+    try {
+        allocation.mapped = map_if_host_visible(memory_type, allocation.memory, size);
+    } catch (...) {
+        m_backend->free(allocation.memory);
+        throw;
+    }
+
+    m_dedicated.push_back(allocation);
+    return allocation;
+}
+
+DeviceAllocator::MemoryBlock& DeviceAllocator::create_block(uint32_t memory_type, AllocationStrategy strategy,
+                                                            uint32_t& block_index) {
+    auto block         = std::make_unique<MemoryBlock>();
+    block->memory_type = memory_type;
+    block->strategy    = strategy;
+
+    if (strategy == AllocationStrategy::Buddy) {
+        block->buddy.init(MIN_NODE_SIZE, static_cast<uint32_t>(std::countr_zero(m_block_size / MIN_NODE_SIZE)));
+    } else {
+        block->linear.init(m_block_size);
+    }
+
+    if (m_backend->allocate(memory_type, m_block_size, &block->memory) != VK_SUCCESS) {
+        throw std::runtime_error("DeviceAllocator::create_block => failed to allocate device memory block!");
+    }
+
+    try {
+        block->mapped = static_cast<std::byte*>(map_if_host_visible(memory_type, block->memory, m_block_size));
+    } catch (...) {
+        m_backend->free(block->memory);
+        throw;
+    }
+
+    // Reuse a slot released by trim() so block indices of live allocations stay valid.
+    auto free_slot = std::find(m_blocks.begin(), m_blocks.end(), nullptr);
+    if (free_slot != m_blocks.end()) {
+        *free_slot  = std::move(block);
+        block_index = static_cast<uint32_t>(free_slot - m_blocks.begin());
+    } else {
+        m_blocks.push_back(std::move(block));
+        block_index = static_cast<uint32_t>(m_blocks.size() - 1);
+    }
+
+    return *m_blocks[block_index];
+}
+
+bool DeviceAllocator::try_allocate_from(MemoryBlock& block, VkDeviceSize size, VkDeviceSize alignment,
+                                        Allocation& allocation) {
+    std::optional<VkDeviceSize> offset;
+    uint32_t                    order = 0;
+
+    if (block.strategy == AllocationStrategy::Buddy) {
+        order  = block.buddy.order_for(size, alignment);
+        offset = block.buddy.allocate(order);
+    } else {
+        offset = block.linear.allocate(size, alignment);
+    }
+
+    if (!offset) {
+        return false;
+    }
+
+    allocation.memory      = block.memory;
+    allocation.offset      = *offset;
+    allocation.memory_type = block.memory_type;
+    allocation.order       = order;
+    allocation.strategy    = block.strategy;
+    allocation.mapped      = block.mapped ? block.mapped + *offset : nullptr;
+
+    return true;
+}
+
+void* DeviceAllocator::map_if_host_visible(uint32_t memory_type, VkDeviceMemory memory, VkDeviceSize size) {
+    if (!(m_memory_properties.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+        return nullptr;
+    }
+
+    void* data = nullptr;
+    if (m_backend->map(memory, size, &data) != VK_SUCCESS) {
+        throw std::runtime_error("DeviceAllocator::map_if_host_visible => failed to map device memory!");
+    }
+
+    return data;
+}
+
+}  // namespace renderer
@@ -0,0 +1,843 @@
+#include "application.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "build_config.hpp"
+#include "pipeline.hpp"
+
+namespace renderer {
+
+namespace {
+
+double average(const std::vector<double>& samples) {
+    double total = 0.0;
+    for (double sample : samples) {
+        total += sample;
+    }
+
+    return samples.empty() ? 0.0 : total / samples.size();
+}
+
+// Where the binary lives (bin/<config>/), so files it ships with are found from any working directory. Falls back to
+// bin/<config>/, relative to the working directory, where /proc is not available.
+std::filesystem::path executable_directory() {
+    std::error_code       error;
+    std::filesystem::path executable = std::filesystem::read_symlink("/proc/self/exe", error);
+
+    return error ? std::filesystem::path("bin") / BUILD_CONFIG_NAME : executable.parent_path();
+}
+
+void transition_image(VkCommandBuffer command_buffer, VkImage image, VkImageLayout old_layout, VkImageLayout new_layout,
+                      VkPipelineStageFlags src_stage, VkAccessFlags src_access, VkPipelineStageFlags dst_stage,
+                      VkAccessFlags dst_access) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask                   = src_access;
+    barrier.dstAccessMask                   = dst_access;
+    barrier.oldLayout                       = old_layout;
+    barrier.newLayout                       = new_layout;
+    barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image                           = image;
+    barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel   = 0;
+    barrier.subresourceRange.levelCount     = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount     = 1;
+
+    vkCmdPipelineBarrier(command_buffer, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+}  // namespace
+
+ApplicationOptions parse_options(int argc, char** argv) {
+    ApplicationOptions options{};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view argument = argv[i];
+
+        if (argument == "--headless") {
+            options.headless = true;
+        } else if (argument == "--frames" && i + 1 < argc) {
+            options.benchmark_frames = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (argument == "--draws" && i + 1 < argc) {
+            options.draw_count = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (argument == "--threads" && i + 1 < argc) {
+            options.record_threads = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (argument == "--record-sweep") {
+            options.record_sweep = true;
+        } else if (argument == "--instances" && i + 1 < argc) {
+            options.instance_count = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (argument == "--instance-sweep") {
+            options.instance_sweep = true;
+        } else if (argument == "--gpu-cull") {
+            options.gpu_culling = true;
+        } else if (argument == "--bindless") {
+            options.bindless = true;
+        } else if (argument == "--stream-mb" && i + 1 < argc) {
+            options.stream_mb = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (argument == "--upload-queue" && i + 1 < argc) {
+            std::string_view upload_queue = argv[++i];
+            if (upload_queue == "transfer") {
+                options.upload_queue = UploadQueueMode::Transfer;
+            } else if (upload_queue == "graphics") {
+                options.upload_queue = UploadQueueMode::Graphics;
+            } else if (upload_queue == "blocking") {
+                options.upload_queue = UploadQueueMode::Blocking;
+            } else {
+                throw std::runtime_error("parse_options => unknown upload queue: " + std::string(upload_queue));
+            }
+        } else if (argument == "--command-pool-reset" && i + 1 < argc) {
+            std::string_view strategy = argv[++i];
+            if (strategy == "pool") {
+                options.command_pool_strategy = CommandPoolStrategy::PerFramePool;
+            } else if (strategy == "buffer") {
+                options.command_pool_strategy = CommandPoolStrategy::PerBufferReset;
+            } else {
+                throw std::runtime_error("parse_options => unknown command pool reset strategy: " +
+                                         std::string(strategy));
+            }
+        } else if (argument == "--sync" && i + 1 < argc) {
+            std::string_view sync_mode = argv[++i];
+            if (sync_mode == "fence") {
+                options.frame_sync_mode = FrameSyncMode::Fences;
+            } else if (sync_mode == "timeline") {
+                options.frame_sync_mode = FrameSyncMode::Timeline;
+            } else {
+                throw std::runtime_error("parse_options => unknown sync mode: " + std::string(sync_mode));
+            }
+        } else if (argument == "--render-pass") {
+            options.render_pass = true;
+        } else if (argument == "--hot-reload") {
+            options.hot_reload = true;
+        } else if (argument == "--pipeline-threads" && i + 1 < argc) {
+            options.pipeline_threads = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (argument == "--gpu-trace" && i + 1 < argc) {
+            options.gpu_trace_path = argv[++i];
+        } else if (argument == "--cpu-trace" && i + 1 < argc) {
+            options.cpu_trace_path = argv[++i];
+        } else {
+            throw std::runtime_error("parse_options => unknown argument: " + std::string(argument));
+        }
+    }
+
+    return options;
+}
+
+Application::Application(std::string name, const ApplicationOptions& options)
+    : m_name(std::move(name)), m_options(options) {}
+
+void Application::run() {
+    auto startup_start = std::chrono::steady_clock::now();
+    init();
+    auto startup_end = std::chrono::steady_clock::now();
+
+    // Compare a cold launch (no bin/<config>/cache) with a warm one to see what the pipeline cache saves.
+    std::cout << m_name << "::run => startup: "
+              << std::chrono::duration<double, std::milli>(startup_end - startup_start).count() << " ms, "
+              << (m_pipeline_cache.warm() ? "warm" : "cold") << " pipeline cache (" << m_pipeline_cache.loaded_size()
+              << " bytes loaded)\n";
+
+    if (m_options.headless && m_options.record_sweep) {
+        run_record_sweep();
+    } else if (m_options.headless && m_options.instance_sweep) {
+        run_instance_sweep();
+    } else if (m_options.headless) {
+        run_benchmark();
+    } else {
+        main_loop();
+    }
+
+    m_gpu_profiler.print_stats(std::cout);
+    m_frame_tracer.drain();
+    m_frame_tracer.print_report(std::cout);
+
+    cleanup();
+}
+
+/* ---- Initialization and lifecycle ---- */
+
+void Application::init() {
+    m_frame_tracer.init(m_options.cpu_trace_path);
+
+    if (!m_options.headless) {
+        init_glfw();
+        init_window();
+    }
+
+    init_vulkan();
+}
+
+void Application::init_glfw() {
+    if (!glfwInit()) {
+        throw std::runtime_error("Application::init_glfw => Failed to initialize GLFW.");
+    }
+}
+
+void Application::init_window() {
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+
+    m_window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, m_name.c_str(), nullptr, nullptr);
+    if (!m_window) {
+        glfwTerminate();
+        throw std::runtime_error("Application::init_window => Failed to create GLFW window");
+    }
+
+    glfwSetWindowUserPointer(m_window, this);
+    glfwSetFramebufferSizeCallback(m_window, framebuffer_resize_callback);
+}
+
+void Application::framebuffer_resize_callback(GLFWwindow* window, int width, int height) {
+    Application* app           = static_cast<Application*>(glfwGetWindowUserPointer(window));
+    app->m_framebuffer_resized = true;
+
+    (void)width;
+    (void)height;
+}
+
+void Application::init_vulkan() {
+    m_context.init(m_name, m_window);
+
+    if (m_options.headless) {
+        m_swapchain.init_offscreen(m_context, {WINDOW_WIDTH, WINDOW_HEIGHT}, MAX_FRAMES_IN_FLIGHT);
+    } else {
+        m_swapchain.init(m_context);
+    }
+
+    const std::filesystem::path directory = executable_directory();
+
+    m_pipeline_cache.init(m_context, (directory / PIPELINE_CACHE_DIRECTORY).string(), m_name);
+
+    // Shaders come from the binary in EMBED_SHADERS=1 builds, else from the archive, else from their files. Hot reload
+    // rebuilds pipelines from the recompiled files, so it cannot work with the former and skips the archive.
+    if (embedded_shader_count() > 0) {
+        std::cout << m_name << "::init_vulkan => " << embedded_shader_count() << " shaders embedded in the binary\n";
+        if (m_options.hot_reload) {
+            std::cout << m_name << "::init_vulkan => --hot-reload has no effect with embedded shaders\n";
+            m_options.hot_reload = false;
+        }
+    } else if (m_options.hot_reload) {
+        m_shader_watcher.init((directory / SHADER_SOURCE_DIRECTORY).lexically_normal().string(),
+                              (directory / SHADER_OUTPUT_DIRECTORY).lexically_normal().string());
+    } else if (m_shader_archive.init((directory / SHADER_ARCHIVE_NAME).string())) {
+        std::cout << m_name << "::init_vulkan => " << m_shader_archive.size() << " shaders packed in "
+                  << m_shader_archive.path() << "\n";
+    } else {
+        std::cout << m_name << "::init_vulkan => no shader archive, loading shaders from their files\n";
+    }
+
+    // Dynamic rendering needs neither a render pass nor framebuffers; the render pass path is the fallback.
+    m_dynamic_rendering = m_context.features().dynamic_rendering && !m_options.render_pass;
+    if (!m_dynamic_rendering) {
+        m_render_pass = create_render_pass(m_context.device(), m_swapchain.format(), m_swapchain.final_layout());
+        create_framebuffers();
+    }
+    std::cout << m_name << "::init_vulkan => drawing with "
+              << (m_dynamic_rendering ? "dynamic rendering" : "a render pass and framebuffers") << "\n";
+
+    m_render_pass_layout.color_format = m_swapchain.format();
+    m_render_pass_layout.samples      = VK_SAMPLE_COUNT_1_BIT;
+    m_pipeline_states.init(m_context, m_pipeline_cache.handle(), &m_shader_archive);
+    m_pipeline_states.add_render_pass(m_render_pass_layout, m_render_pass);  // null with dynamic rendering
+    if (m_options.pipeline_threads > 0) {
+        m_pipeline_compiler.init(m_pipeline_states, m_options.pipeline_threads);
+    }
+
+    m_frame_scheduler.init(m_context, m_swapchain.image_count(), m_options.command_pool_strategy,
+                           m_options.frame_sync_mode);
+    m_frame_scheduler.set_tracer(&m_frame_tracer);
+    m_job_system.init(m_options.record_threads);
+    m_parallel_recorder.init(m_context, m_job_system);
+    m_gpu_profiler.init(m_context, m_options.gpu_trace_path);
+    m_upload_context.init(m_context);
+    m_upload_context.set_profiler(&m_gpu_profiler);
+    m_upload_scheduler.init(m_context, m_options.upload_queue == UploadQueueMode::Transfer);
+    m_frame_ring.init(m_context, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    if (m_options.bindless && !BindlessTable::supported(m_context)) {
+        std::cout << m_name << "::init_vulkan => no descriptor indexing, --bindless falls back to vertex attributes\n";
+        m_options.bindless = false;
+    }
+    if (m_options.bindless) {
+        m_bindless_table.init(m_context, m_frame_scheduler);
+    }
+
+    if (m_options.stream_mb > 0) {
+        VkDeviceSize stream_size = VkDeviceSize{m_options.stream_mb} * 1024 * 1024;
+
+        m_stream_buffer = create_buffer(m_context, stream_size * MAX_FRAMES_IN_FLIGHT,
+                                        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        m_stream_data.assign(static_cast<size_t>(stream_size), std::byte{0x5a});
+    }
+
+    create_scene();
+}
+
+void Application::main_loop() {
+    while (!glfwWindowShouldClose(m_window)) {
+        glfwPollEvents();
+        draw_frame();
+    }
+}
+
+void Application::cleanup() {
+    // Wait until the device is idle before destroying resources to ensure no commands are
+    // still referencing swapchain images, semaphores, fences, framebuffers, etc.
+    vkDeviceWaitIdle(m_context.device());
+
+    if (m_options.hot_reload) {
+        m_shader_watcher.cleanup();
+    }
+    if (m_options.pipeline_threads > 0) {
+        m_pipeline_compiler.cleanup();
+    }
+    destroy_scene();
+    m_pipeline_states.cleanup();
+    m_pipeline_cache.cleanup();
+    m_shader_archive.cleanup();
+
+    destroy_framebuffers();
+    m_swapchain.cleanup();
+
+    vkDestroyRenderPass(m_context.device(), m_render_pass, nullptr);
+
+    if (m_stream_buffer.buffer != VK_NULL_HANDLE) {
+        destroy_buffer(m_context, m_stream_buffer);
+    }
+
+    if (m_options.bindless) {
+        m_bindless_table.cleanup();
+    }
+    m_frame_ring.cleanup();
+    m_upload_scheduler.cleanup();
+    m_upload_context.cleanup();
+    m_gpu_profiler.cleanup();
+    m_parallel_recorder.cleanup();
+    m_job_system.cleanup();
+    m_frame_scheduler.cleanup();
+    m_context.cleanup();
+
+    if (m_window != nullptr) {
+        glfwDestroyWindow(m_window);
+        glfwTerminate();
+    }
+
+    m_frame_tracer.cleanup();
+}
+
+/* ---- Frame loop ---- */
+
+void Application::create_framebuffers() {
+    m_swapchain_framebuffers.resize(m_swapchain.image_count());
+
+    for (uint32_t i = 0; i < m_swapchain.image_count(); ++i) {
+        VkImageView attachments[] = {m_swapchain.image_view(i)};
+
+        VkFramebufferCreateInfo framebuffer_create_info{};
+        framebuffer_create_info.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebuffer_create_info.renderPass      = m_render_pass;
+        framebuffer_create_info.attachmentCount = 1;
+        framebuffer_create_info.pAttachments    = attachments;
+        framebuffer_create_info.width           = m_swapchain.extent().width;
+        framebuffer_create_info.height          = m_swapchain.extent().height;
+        framebuffer_create_info.layers          = 1;
+
+        if (vkCreateFramebuffer(m_context.device(), &framebuffer_create_info, nullptr, &m_swapchain_framebuffers[i]) !=
+            VK_SUCCESS) {
+            throw std::runtime_error("Application::create_framebuffers => failed to create framebuffer!");
+        }
+    }
+}
+
+void Application::destroy_framebuffers() {
+    for (VkFramebuffer framebuffer : m_swapchain_framebuffers) {
+        vkDestroyFramebuffer(m_context.device(), framebuffer, nullptr);
+    }
+
+    m_swapchain_framebuffers.clear();
+}
+
+void Application::recreate_swapchain() {
+    auto recreate_start = std::chrono::steady_clock::now();
+
+    // Swapchain::recreate() waits for the device to go idle before touching any image. With dynamic rendering the
+    // new image views are all there is to rebuild.
+    if (m_dynamic_rendering) {
+        m_swapchain.recreate();
+    } else {
+        destroy_framebuffers();
+        m_swapchain.recreate();
+        create_framebuffers();
+    }
+
+    m_frame_scheduler.reset_images_in_flight(m_swapchain.image_count());
+
+    auto recreate_end = std::chrono::steady_clock::now();
+    std::cout << m_name << "::recreate_swapchain => "
+              << std::chrono::duration<double, std::milli>(recreate_end - recreate_start).count() << " ms\n";
+
+    // Not recreating render passes for simplicty
+    // https://vulkan-tutorial.com/Drawing_a_triangle/Swap_chain_recreation
+}
+
+void Application::record_command_buffer(const FrameContext& frame) {
+    VkCommandBuffer command_buffer = frame.command_buffer;
+
+    VkCommandBufferBeginInfo command_buffer_begin_info{};
+    command_buffer_begin_info.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    command_buffer_begin_info.flags            = 0;        // Optional
+    command_buffer_begin_info.pInheritanceInfo = nullptr;  // Optional
+
+    if (vkBeginCommandBuffer(command_buffer, &command_buffer_begin_info) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "Application::record_command_buffer => failed to begin recording command "
+            "buffer!");
+    }
+
+    m_gpu_profiler.begin(command_buffer, frame.frame_index, "frame");
+
+    m_upload_scheduler.acquire(command_buffer, m_frame_scheduler);
+
+    uint32_t prepass_scope = m_gpu_profiler.begin_scope(command_buffer, frame.frame_index, "prepass");
+    record_prepass(command_buffer);
+    m_gpu_profiler.end_scope(command_buffer, frame.frame_index, prepass_scope);
+
+    // Secondary command buffers only pay off once there is enough to record on more than one thread.
+    const uint32_t draw_count = scene_draw_count();
+    const bool     parallel   = m_job_system.worker_count() > 1 && draw_count > 1;
+
+    uint32_t render_pass_scope = m_gpu_profiler.begin_scope(command_buffer, frame.frame_index, "render_pass");
+
+    if (parallel) {
+        begin_rendering(command_buffer, frame, true);
+
+        auto record_range = [this](VkCommandBuffer secondary_command_buffer, uint32_t first_draw,
+                                   uint32_t range_draw_count) {
+            FrameTracer::Scope record_job_scope(&m_frame_tracer, "record_job");
+
+            // Dynamic state is not inherited by secondary command buffers.
+            set_viewport_and_scissor(secondary_command_buffer);
+            record_scene(secondary_command_buffer, first_draw, range_draw_count);
+        };
+
+        const std::vector<VkCommandBuffer>& secondary_command_buffers =
+            m_dynamic_rendering
+                ? m_parallel_recorder.record(frame.frame_index, m_render_pass_layout, draw_count, record_range)
+                : m_parallel_recorder.record(frame.frame_index, m_render_pass,
+                                             m_swapchain_framebuffers[frame.image_index], draw_count, record_range);
+
+        vkCmdExecuteCommands(command_buffer, static_cast<uint32_t>(secondary_command_buffers.size()),
+                             secondary_command_buffers.data());
+    } else {
+        begin_rendering(command_buffer, frame, false);
+
+        // Timestamps can only be written into the primary buffer, so draws get their own scope on this path only.
+        uint32_t draws_scope = m_gpu_profiler.begin_scope(command_buffer, frame.frame_index, "draws");
+        set_viewport_and_scissor(command_buffer);
+        record_scene(command_buffer, 0, draw_count);
+        m_gpu_profiler.end_scope(command_buffer, frame.frame_index, draws_scope);
+    }
+
+    end_rendering(command_buffer, frame);
+
+    m_gpu_profiler.end_scope(command_buffer, frame.frame_index, render_pass_scope);
+    m_gpu_profiler.end(command_buffer, frame.frame_index);
+
+    if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Application::record_command_buffer => failed to record command buffer!");
+    }
+}
+
+// Begins the render pass, or with dynamic rendering the equivalent render pass instance: the image is transitioned
+// from UNDEFINED here, as the render pass's initial layout and external dependency did, and cleared on load.
+void Application::begin_rendering(VkCommandBuffer command_buffer, const FrameContext& frame, bool secondary) {
+    VkClearValue clear_color = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
+
+    if (!m_dynamic_rendering) {
+        VkRenderPassBeginInfo render_pass_begin_info{};
+        render_pass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        render_pass_begin_info.renderPass        = m_render_pass;
+        render_pass_begin_info.framebuffer       = m_swapchain_framebuffers[frame.image_index];
+        render_pass_begin_info.renderArea.offset = {0, 0};
+        render_pass_begin_info.renderArea.extent = m_swapchain.extent();
+        render_pass_begin_info.clearValueCount   = 1;
+        render_pass_begin_info.pClearValues      = &clear_color;
+
+        vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info,
+                             secondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+        return;
+    }
+
+    // The submit waits for the acquired image at COLOR_ATTACHMENT_OUTPUT, so the transition must not start earlier.
+    transition_image(command_buffer, m_swapchain.image(frame.image_index), VK_IMAGE_LAYOUT_UNDEFINED,
+                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0,
+                     VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+
+    VkRenderingAttachmentInfoKHR color_attachment{};
+    color_attachment.sType       = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    color_attachment.imageView   = m_swapchain.image_view(frame.image_index);
+    color_attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color_attachment.loadOp      = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color_attachment.storeOp     = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment.clearValue  = clear_color;
+
+    VkRenderingInfoKHR rendering_info{};
+    rendering_info.sType                = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    rendering_info.flags                = secondary ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR : 0;
+    rendering_info.renderArea.offset    = {0, 0};
+    rendering_info.renderArea.extent    = m_swapchain.extent();
+    rendering_info.layerCount           = 1;
+    rendering_info.colorAttachmentCount = 1;
+    rendering_info.pColorAttachments    = &color_attachment;
+
+    m_context.cmd_begin_rendering(command_buffer, rendering_info);
+}
+
+void Application::end_rendering(VkCommandBuffer command_buffer, const FrameContext& frame) {
+    if (!m_dynamic_rendering) {
+        vkCmdEndRenderPass(command_buffer);
+        return;
+    }
+
+    m_context.cmd_end_rendering(command_buffer);
+
+    // The render pass's final layout: present, or transfer source for offscreen images.
+    transition_image(command_buffer, m_swapchain.image(frame.image_index), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                     m_swapchain.final_layout(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                     VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+}
+
+void Application::set_viewport_and_scissor(VkCommandBuffer command_buffer) {
+    VkViewport viewport{};
+    viewport.x        = 0.0f;
+    viewport.y        = 0.0f;
+    viewport.width    = static_cast<float>(m_swapchain.extent().width);
+    viewport.height   = static_cast<float>(m_swapchain.extent().height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = m_swapchain.extent();
+    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+}
+
+// Uploads the frame's --stream-mb region, standing in for assets streamed in while rendering. The region was last
+// written MAX_FRAMES_IN_FLIGHT frames ago, and that frame has completed.
+void Application::stream_uploads(uint32_t frame_index) {
+    if (m_options.stream_mb == 0) {
+        return;
+    }
+
+    VkDeviceSize stream_size = m_stream_data.size();
+    VkDeviceSize offset      = frame_index * stream_size;
+
+    if (m_options.upload_queue == UploadQueueMode::Blocking) {
+        m_upload_context.upload(m_stream_buffer.buffer, offset, m_stream_data.data(), stream_size);
+    } else {
+        m_upload_scheduler.upload(m_stream_buffer.buffer, offset, m_stream_data.data(), stream_size);
+    }
+}
+
+// Called between frames: the frame about to be recorded resolves the rebuilt pipelines, the ones they replace are
+// destroyed once every frame submitted so far has completed. Nothing waits for the device.
+void Application::reload_shaders() {
+    for (const ShaderChange& change : m_shader_watcher.take_changes()) {
+        std::vector<PipelineRebuild> rebuilds =
+            m_pipeline_states.rebuild(change.spv_path, m_frame_scheduler.submitted_value());
+
+        std::cout << m_name << "::reload_shaders => " << shader_name(change.spv_path) << " compiled in "
+                  << change.compile_ms << " ms, " << rebuilds.size() << " pipelines use it\n";
+        for (const PipelineRebuild& rebuild : rebuilds) {
+            std::cout << '\t' << shader_name(rebuild.vert_shader_path) << " + " << shader_name(rebuild.frag_shader_path)
+                      << ": ";
+            if (rebuild.rebuilt) {
+                std::cout << "rebuilt in " << rebuild.rebuild_ms << " ms\n";
+            } else {
+                std::cout << "failed after " << rebuild.rebuild_ms << " ms, keeping the previous pipeline\n";
+            }
+        }
+    }
+}
+
+void Application::draw_frame() {
+    // Fold the previous frame's stage timings into the histograms before this frame starts timing its own.
+    m_frame_tracer.drain();
+    FrameTracer::Scope frame_scope(&m_frame_tracer, "frame");
+
+    FrameContext frame{};
+    if (!m_frame_scheduler.begin_frame(m_swapchain, frame)) {
+        recreate_swapchain();
+        return;
+    }
+
+    // The frame's fence has signaled, so last time's timestamps and ring buffer region of this slot are free.
+    collect_gpu_profile(frame.frame_index);
+    m_frame_ring.begin_frame(frame.frame_index);
+    m_pipeline_states.reclaim(m_frame_scheduler);
+    if (m_options.hot_reload) {
+        reload_shaders();
+    }
+    if (m_options.bindless) {
+        m_bindless_table.reclaim();
+    }
+
+    auto cpu_start = std::chrono::steady_clock::now();
+
+    FrameTracer::Scope update_scope(&m_frame_tracer, "update");
+    update_scene(frame.frame_index);
+    update_scope.end();
+    if (std::exchange(m_pipeline_fallback, false)) {
+        m_pipeline_fallback_frames++;
+    }
+
+    FrameTracer::Scope upload_scope(&m_frame_tracer, "upload");
+    stream_uploads(frame.frame_index);
+    m_upload_scheduler.flush();
+    upload_scope.end();
+
+    FrameTracer::Scope record_scope(&m_frame_tracer, "record");
+    record_command_buffer(frame);
+    record_scope.end();
+    auto record_end = std::chrono::steady_clock::now();
+
+    bool swapchain_ok = m_frame_scheduler.end_frame(m_swapchain, frame);
+
+    if (m_options.headless) {
+        auto cpu_end = std::chrono::steady_clock::now();
+        m_frame_timings.cpu_ms.push_back(std::chrono::duration<double, std::milli>(cpu_end - cpu_start).count());
+        m_frame_timings.record_ms.push_back(
+            std::chrono::duration<double, std::milli>(record_end - cpu_start).count());
+        return;
+    }
+
+    if (!swapchain_ok || m_framebuffer_resized) {
+        m_framebuffer_resized = false;
+        recreate_swapchain();
+    }
+}
+
+/* ---- Pipelines ---- */
+
+uint64_t Application::request_pipeline(const GraphicsPipelineDesc& desc) {
+    if (m_options.pipeline_threads > 0) {
+        return m_pipeline_compiler.request(desc, m_render_pass_layout);
+    }
+
+    m_pipeline_states.get(desc, m_render_pass_layout);
+    return m_pipeline_states.key(desc, m_render_pass_layout);
+}
+
+GraphicsPipeline Application::resolve_pipeline(uint64_t key, const GraphicsPipeline& fallback) {
+    GraphicsPipeline pipeline = m_pipeline_states.find(key);
+    if (pipeline.pipeline != VK_NULL_HANDLE) {
+        return pipeline;
+    }
+
+    m_pipeline_fallback = true;
+    return fallback;
+}
+
+/* ---- Headless benchmark ---- */
+
+// Renders a fixed number of frames without presenting and reports throughput and frame timings.
+void Application::run_benchmark() {
+    const uint32_t frame_count = m_options.benchmark_frames;
+
+    m_frame_timings.cpu_ms.reserve(frame_count);
+    m_frame_timings.record_ms.reserve(frame_count);
+    m_frame_timings.gpu_ms.reserve(frame_count);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frame_count; ++i) {
+        draw_frame();
+    }
+    vkDeviceWaitIdle(m_context.device());
+    auto end = std::chrono::steady_clock::now();
+
+    // The last frames in flight were never waited on by draw_frame(), collect them now.
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        collect_gpu_profile(i);
+    }
+
+    double elapsed_s = std::chrono::duration<double>(end - start).count();
+    print_benchmark_report(frame_count, elapsed_s);
+}
+
+// Repeats the headless benchmark over a grid of draw and thread counts and reports the average time spent
+// recording command buffers, i.e. how recording scales with --threads.
+void Application::run_record_sweep() {
+    const std::array<uint32_t, 3> draw_counts   = {1'000, 10'000, 100'000};
+    const std::array<uint32_t, 4> thread_counts = {1, 2, 4, 8};
+
+    std::cout << m_name << "::run_record_sweep => avg record ms over " << m_options.benchmark_frames
+              << " frames (rows: draws, columns: threads)\n\t";
+    for (uint32_t thread_count : thread_counts) {
+        std::cout << '\t' << thread_count;
+    }
+    std::cout << '\n';
+
+    for (uint32_t draw_count : draw_counts) {
+        m_options.draw_count = draw_count;
+        std::cout << '\t' << draw_count;
+
+        for (uint32_t thread_count : thread_counts) {
+            set_record_threads(thread_count);
+            m_frame_timings = {};
+
+            for (uint32_t i = 0; i < m_options.benchmark_frames; ++i) {
+                draw_frame();
+            }
+
+            std::cout << '\t' << average(m_frame_timings.record_ms) << std::flush;
+        }
+        std::cout << '\n';
+    }
+
+    vkDeviceWaitIdle(m_context.device());
+}
+
+// Draws the same number of objects once as a single instanced draw and once as one draw per object, and reports
+// the average CPU and GPU frame time of both, i.e. what collapsing draws into instances saves.
+void Application::run_instance_sweep() {
+    const std::array<uint32_t, 4> instance_counts = {1'000, 10'000, 100'000, 1'000'000};
+
+    std::cout << m_name << "::run_instance_sweep => avg ms over " << m_options.benchmark_frames
+              << " frames (instanced: 1 draw of N instances, per-draw: N draws of 1 instance)\n"
+              << "\tobjects\tinstanced cpu\tinstanced gpu\tper-draw cpu\tper-draw gpu\n";
+
+    for (uint32_t instance_count : instance_counts) {
+        std::cout << '\t' << instance_count;
+
+        for (bool instanced : {true, false}) {
+            m_options.instance_count = instanced ? instance_count : 0;
+            m_options.draw_count     = instanced ? 1 : instance_count;
+            m_frame_timings          = {};
+
+            for (uint32_t i = 0; i < m_options.benchmark_frames; ++i) {
+                draw_frame();
+            }
+
+            // Frames still in flight are part of this configuration, not the next one.
+            vkDeviceWaitIdle(m_context.device());
+            for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+                collect_gpu_profile(i);
+            }
+
+            std::cout << '\t' << average(m_frame_timings.cpu_ms) << '\t' << average(m_frame_timings.gpu_ms)
+                      << std::flush;
+        }
+        std::cout << '\n';
+    }
+}
+
+void Application::set_record_threads(uint32_t thread_count) {
+    // The recorder's worker pools may still be referenced by frames in flight.
+    vkDeviceWaitIdle(m_context.device());
+
+    m_parallel_recorder.cleanup();
+    m_job_system.cleanup();
+
+    m_job_system.init(thread_count);
+    m_parallel_recorder.init(m_context, m_job_system);
+}
+
+void Application::print_benchmark_report(uint32_t frame_count, double elapsed_s) {
+    auto summarize = [](const char* label, std::vector<double> samples) {
+        if (samples.empty()) {
+            std::cout << '\t' << label << ": n/a\n";
+            return;
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        double total = 0.0;
+        for (double sample : samples) {
+            total += sample;
+        }
+
+        std::cout << '\t' << label << ": avg " << total / samples.size() << " ms, p50 " << samples[samples.size() / 2]
+                  << " ms, p99 " << samples[(samples.size() * 99) / 100] << " ms, max " << samples.back() << " ms\n";
+    };
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_context.physical_device(), &properties);
+
+    std::cout << m_name << "::run_benchmark => " << frame_count << " frames on " << properties.deviceName << " ("
+              << m_swapchain.extent().width << "x" << m_swapchain.extent().height << "), " << BUILD_CONFIG_NAME
+              << " build" << (ENABLE_VALIDATION_LAYERS ? " with validation layers" : "") << "\n";
+    std::cout << '\t' << "elapsed: " << elapsed_s << " s, " << frame_count / elapsed_s << " frames/s\n";
+    summarize("cpu", m_frame_timings.cpu_ms);
+    summarize("record", m_frame_timings.record_ms);
+    summarize("gpu", m_frame_timings.gpu_ms);
+
+    // Run once with --command-pool-reset pool and once with buffer to compare the two recycling strategies.
+    const FrameSchedulerStats& scheduler_stats = m_frame_scheduler.stats();
+    std::cout << '\t' << "command pool reset ("
+              << (m_frame_scheduler.strategy() == CommandPoolStrategy::PerFramePool ? "pool" : "buffer")
+              << "): " << scheduler_stats.command_pool_resets << " vkResetCommandPool, "
+              << scheduler_stats.command_buffer_resets << " vkResetCommandBuffer, "
+              << scheduler_stats.reset_ms * 1000.0 / std::max<uint64_t>(scheduler_stats.frames, 1) << " us/frame\n";
+    std::cout << '\t' << "frame sync ("
+              << (m_frame_scheduler.sync_mode() == FrameSyncMode::Timeline ? "timeline" : "fence")
+              << "): " << scheduler_stats.host_waits << " blocking host waits\n";
+
+    const PipelineStateStats pipeline_stats = m_pipeline_states.stats();
+    std::cout << '\t' << "pipeline states: " << pipeline_stats.pipelines_created << " pipelines and "
+              << pipeline_stats.layouts_created << " layouts created in " << pipeline_stats.create_ms << " ms, "
+              << pipeline_stats.deduplicated << " requests deduplicated\n";
+
+    // Run once with --pipeline-threads 0 to compare against compiling on the render thread during create_scene().
+    if (m_options.pipeline_threads > 0) {
+        const PipelineCompilerStats compiler_stats = m_pipeline_compiler.stats();
+        std::cout << '\t' << "pipeline compiler: " << compiler_stats.compiled << " of " << compiler_stats.requested
+                  << " compiled on " << m_options.pipeline_threads << " threads, latency avg "
+                  << compiler_stats.total_latency_ms / std::max<uint64_t>(compiler_stats.compiled, 1) << " ms / max "
+                  << compiler_stats.max_latency_ms << " ms, " << m_pipeline_fallback_frames
+                  << " frames on fallback\n";
+    }
+
+    if (m_options.hot_reload) {
+        std::cout << '\t' << "shader hot reload: " << pipeline_stats.pipelines_rebuilt << " pipelines rebuilt, avg "
+                  << pipeline_stats.rebuild_ms / std::max<uint64_t>(pipeline_stats.pipelines_rebuilt, 1)
+                  << " ms / max " << pipeline_stats.max_rebuild_ms << " ms\n";
+    }
+
+    std::cout << '\t' << "frame ring: " << m_frame_ring.peak_used() / 1024 << " of "
+              << m_frame_ring.region_size() / 1024 << " KiB per frame used at peak, "
+              << (m_frame_ring.device_local() ? "device local" : "system") << " memory\n";
+
+    // Run once with --stream-mb 0 to see how much frame time the streamed uploads add.
+    if (m_options.stream_mb > 0) {
+        const UploadSchedulerStats& upload_stats = m_upload_scheduler.stats();
+        std::cout << '\t' << "upload stream: " << m_options.stream_mb << " MiB/frame, ";
+        if (m_options.upload_queue == UploadQueueMode::Blocking) {
+            std::cout << "blocking on the graphics queue\n";
+        } else {
+            std::cout << (m_upload_scheduler.async() ? "transfer" : "graphics") << " queue family "
+                      << m_upload_scheduler.queue_family() << ", " << upload_stats.batches << " batches, "
+                      << upload_stats.host_waits << " blocking host waits ("
+                      << upload_stats.wait_ms / std::max<uint64_t>(scheduler_stats.frames, 1) << " ms/frame)\n";
+        }
+    }
+}
+
+void Application::collect_gpu_profile(uint32_t slot) {
+    const GpuFrameProfile* profile = m_gpu_profiler.collect(slot);
+
+    if (profile != nullptr && m_options.headless) {
+        m_frame_timings.gpu_ms.push_back(profile->scopes[0].duration_ms);
+    }
+}
+
+}  // namespace renderer
@@ -0,0 +1,227 @@
+#include "bindless_table.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <stdexcept>
+
+namespace renderer {
+
+/* ---- SlotAllocator ---- */
+
+void SlotAllocator::init(uint32_t capacity) {
+    m_capacity = capacity;
+    m_next     = 0;
+    m_free.clear();
+    m_retired.clear();
+}
+
+std::optional<uint32_t> SlotAllocator::allocate() {
+    if (!m_free.empty()) {
+        uint32_t slot = m_free.back();
+        m_free.pop_back();
+        return slot;
+    }
+
+    if (m_next < m_capacity) {
+        return m_next++;
+    }
+
+    return std::nullopt;
+}
+
+void SlotAllocator::release(uint32_t slot, uint64_t retire_value) {
+    m_retired.push_back({slot, retire_value});
+}
+
+void SlotAllocator::reclaim(FrameScheduler& frame_scheduler) {
+    while (!m_retired.empty() && frame_scheduler.is_complete(m_retired.front().retire_value)) {
+        m_free.push_back(m_retired.front().slot);
+        m_retired.pop_front();
+    }
+}
+
+/* ---- BindlessTable ---- */
+
+void BindlessTable::init(const DeviceContext& context, FrameScheduler& frame_scheduler) {
+    if (!supported(context)) {
+        throw std::runtime_error("BindlessTable::init => the device does not support descriptor indexing!");
+    }
+
+    m_context         = &context;
+    m_frame_scheduler = &frame_scheduler;
+
+    VkPhysicalDeviceVulkan12Properties vulkan_12_properties{};
+    vulkan_12_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &vulkan_12_properties;
+    vkGetPhysicalDeviceProperties2(context.physical_device(), &properties);
+
+    // Both arrays are visible to every stage, so together they also have to fit the per-stage resource limit;
+    // buffers get at most half of it.
+    const uint32_t stage_resources = vulkan_12_properties.maxPerStageUpdateAfterBindResources;
+    const uint32_t buffer_capacity =
+        std::min({MAX_STORAGE_BUFFERS, vulkan_12_properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                  vulkan_12_properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers, stage_resources / 2});
+    // Images are combined image samplers, so they count against the sampler limits as well.
+    const uint32_t image_capacity =
+        std::min({MAX_SAMPLED_IMAGES, vulkan_12_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+                  vulkan_12_properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                  vulkan_12_properties.maxDescriptorSetUpdateAfterBindSamplers,
+                  vulkan_12_properties.maxPerStageDescriptorUpdateAfterBindSamplers,
+                  stage_resources - buffer_capacity});
+
+    m_buffer_slots.init(buffer_capacity);
+    m_image_slots.init(image_capacity);
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[STORAGE_BUFFER_BINDING].binding         = STORAGE_BUFFER_BINDING;
+    bindings[STORAGE_BUFFER_BINDING].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[STORAGE_BUFFER_BINDING].descriptorCount = buffer_capacity;
+    bindings[STORAGE_BUFFER_BINDING].stageFlags      = VK_SHADER_STAGE_ALL;
+
+    bindings[SAMPLED_IMAGE_BINDING].binding         = SAMPLED_IMAGE_BINDING;
+    bindings[SAMPLED_IMAGE_BINDING].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[SAMPLED_IMAGE_BINDING].descriptorCount = image_capacity;
+    bindings[SAMPLED_IMAGE_BINDING].stageFlags      = VK_SHADER_STAGE_ALL;
+
+    const VkDescriptorBindingFlags binding_flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                                   VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+                                                   VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+    std::array<VkDescriptorBindingFlags, 2> bindings_flags = {binding_flags, binding_flags};
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_create_info{};
+    binding_flags_create_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    binding_flags_create_info.bindingCount  = static_cast<uint32_t>(bindings_flags.size());
+    binding_flags_create_info.pBindingFlags = bindings_flags.data();
+
+    VkDescriptorSetLayoutCreateInfo set_layout_create_info{};
+    set_layout_create_info.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    set_layout_create_info.pNext        = &binding_flags_create_info;
+    set_layout_create_info.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    set_layout_create_info.bindingCount = static_cast<uint32_t>(bindings.size());
+    set_layout_create_info.pBindings    = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(context.device(), &set_layout_create_info, nullptr, &m_set_layout) !=
+        VK_SUCCESS) {
+        throw std::runtime_error("BindlessTable::init => failed to create descriptor set layout!");
+    }
+
+    std::array<VkDescriptorPoolSize, 2> pool_sizes{};
+    pool_sizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pool_sizes[0].descriptorCount = buffer_capacity;
+    pool_sizes[1].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    pool_sizes[1].descriptorCount = image_capacity;
+
+    VkDescriptorPoolCreateInfo descriptor_pool_create_info{};
+    descriptor_pool_create_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptor_pool_create_info.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    descriptor_pool_create_info.maxSets       = 1;
+    descriptor_pool_create_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+    descriptor_pool_create_info.pPoolSizes    = pool_sizes.data();
+
+    if (vkCreateDescriptorPool(context.device(), &descriptor_pool_create_info, nullptr, &m_descriptor_pool) !=
+        VK_SUCCESS) {
+        throw std::runtime_error("BindlessTable::init => failed to create descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo descriptor_set_allocate_info{};
+    descriptor_set_allocate_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descriptor_set_allocate_info.descriptorPool     = m_descriptor_pool;
+    descriptor_set_allocate_info.descriptorSetCount = 1;
+    descriptor_set_allocate_info.pSetLayouts        = &m_set_layout;
+
+    if (vkAllocateDescriptorSets(context.device(), &descriptor_set_allocate_info, &m_descriptor_set) != VK_SUCCESS) {
+        throw std::runtime_error("BindlessTable::init => failed to allocate descriptor set!");
+    }
+
+    std::cout << "BindlessTable::init => " << buffer_capacity << " storage buffer and " << image_capacity
+              << " sampled image slots\n";
+}
+
+void BindlessTable::cleanup() {
+    // Freeing the pool frees the set.
+    vkDestroyDescriptorPool(m_context->device(), m_descriptor_pool, nullptr);
+    vkDestroyDescriptorSetLayout(m_context->device(), m_set_layout, nullptr);
+
+    m_descriptor_pool = VK_NULL_HANDLE;
+    m_set_layout      = VK_NULL_HANDLE;
+    m_descriptor_set  = VK_NULL_HANDLE;
+}
+
+uint32_t BindlessTable::add_storage_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+    std::optional<uint32_t> slot = m_buffer_slots.allocate();
+    if (!slot.has_value()) {
+        throw std::runtime_error("BindlessTable::add_storage_buffer => no free storage buffer slot!");
+    }
+
+    VkDescriptorBufferInfo buffer_info{};
+    buffer_info.buffer = buffer;
+    buffer_info.offset = offset;
+    buffer_info.range  = range;
+
+    VkWriteDescriptorSet descriptor_write{};
+    descriptor_write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptor_write.dstSet          = m_descriptor_set;
+    descriptor_write.dstBinding      = STORAGE_BUFFER_BINDING;
+    descriptor_write.dstArrayElement = slot.value();
+    descriptor_write.descriptorCount = 1;
+    descriptor_write.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptor_write.pBufferInfo     = &buffer_info;
+
+    vkUpdateDescriptorSets(m_context->device(), 1, &descriptor_write, 0, nullptr);
+
+    return slot.value();
+}
+
+uint32_t BindlessTable::add_sampled_image(VkImageView image_view, VkSampler sampler, VkImageLayout image_layout) {
+    std::optional<uint32_t> slot = m_image_slots.allocate();
+    if (!slot.has_value()) {
+        throw std::runtime_error("BindlessTable::add_sampled_image => no free sampled image slot!");
+    }
+
+    VkDescriptorImageInfo image_info{};
+    image_info.sampler     = sampler;
+    image_info.imageView   = image_view;
+    image_info.imageLayout = image_layout;
+
+    VkWriteDescriptorSet descriptor_write{};
+    descriptor_write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptor_write.dstSet          = m_descriptor_set;
+    descriptor_write.dstBinding      = SAMPLED_IMAGE_BINDING;
+    descriptor_write.dstArrayElement = slot.value();
+    descriptor_write.descriptorCount = 1;
+    descriptor_write.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptor_write.pImageInfo      = &image_info;
+
+    vkUpdateDescriptorSets(m_context->device(), 1, &descriptor_write, 0, nullptr);
+
+    return slot.value();
+}
+
+void BindlessTable::release_storage_buffer(uint32_t slot) {
+    m_buffer_slots.release(slot, retire_value());
+}
+
+void BindlessTable::release_sampled_image(uint32_t slot) {
+    m_image_slots.release(slot, retire_value());
+}
+
+void BindlessTable::reclaim() {
+    m_buffer_slots.reclaim(*m_frame_scheduler);
+    m_image_slots.reclaim(*m_frame_scheduler);
+}
+
+void BindlessTable::bind(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point,
+                         VkPipelineLayout layout) const {
+    vkCmdBindDescriptorSets(command_buffer, bind_point, layout, 0, 1, &m_descriptor_set, 0, nullptr);
+}
+
+// The frame being recorded has not been submitted yet but may already reference the slot.
+uint64_t BindlessTable::retire_value() const {
+    return m_frame_scheduler->submitted_value() + 1;
+}
+
+}  // namespace renderer
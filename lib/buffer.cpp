@@ -0,0 +1,157 @@
+#include "buffer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace renderer {
+
+Buffer create_buffer(const DeviceContext& context, VkDeviceSize size, VkBufferUsageFlags usage,
+                     VkMemoryPropertyFlags properties, AllocationStrategy strategy) {
+    Buffer buffer{};
+    buffer.size = size;
+
+    VkBufferCreateInfo buffer_create_info{};
+    buffer_create_info.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_create_info.size        = size;
+    buffer_create_info.usage       = usage;
+    buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(context.device(), &buffer_create_info, nullptr, &buffer.buffer) != VK_SUCCESS) {
+        throw std::runtime_error("create_buffer => failed to create buffer!");
+    }
+
+    VkMemoryRequirements memory_requirements;
+    vkGetBufferMemoryRequirements(context.device(), buffer.buffer, &memory_requirements);
+
+    buffer.allocation = context.allocator().allocate(memory_requirements, properties, strategy);
+    vkBindBufferMemory(context.device(), buffer.buffer, buffer.allocation.memory, buffer.allocation.offset);
+
+    return buffer;
+}
+
+void destroy_buffer(const DeviceContext& context, Buffer& buffer) {
+    vkDestroyBuffer(context.device(), buffer.buffer, nullptr);
+    context.allocator().free(buffer.allocation);
+
+    buffer = {};
+}
+
+void UploadContext::init(const DeviceContext& context, VkDeviceSize staging_size) {
+    m_context = &context;
+
+    // Every graphics queue supports transfers, so uploads go through the graphics queue family.
+    uint32_t queue_family = context.queue_family_indices().graphics_family.value();
+    m_queue               = context.graphics_queue();
+
+    VkCommandPoolCreateInfo command_pool_create_info{};
+    command_pool_create_info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    command_pool_create_info.queueFamilyIndex = queue_family;
+    command_pool_create_info.flags =
+        VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+    if (vkCreateCommandPool(context.device(), &command_pool_create_info, nullptr, &m_command_pool) != VK_SUCCESS) {
+        throw std::runtime_error("UploadContext::init => failed to create command pool!");
+    }
+
+    VkCommandBufferAllocateInfo command_buffer_allocate_info{};
+    command_buffer_allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    command_buffer_allocate_info.commandPool        = m_command_pool;
+    command_buffer_allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    command_buffer_allocate_info.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(context.device(), &command_buffer_allocate_info, &m_command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("UploadContext::init => failed to allocate command buffer!");
+    }
+
+    VkFenceCreateInfo fence_create_info{};
+    fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    if (vkCreateFence(context.device(), &fence_create_info, nullptr, &m_fence) != VK_SUCCESS) {
+        throw std::runtime_error("UploadContext::init => failed to create fence!");
+    }
+
+    m_staging_buffer = create_buffer(context, staging_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
+void UploadContext::cleanup() {
+    destroy_buffer(*m_context, m_staging_buffer);
+    vkDestroyFence(m_context->device(), m_fence, nullptr);
+    vkDestroyCommandPool(m_context->device(), m_command_pool, nullptr);
+
+    m_fence          = VK_NULL_HANDLE;
+    m_command_pool   = VK_NULL_HANDLE;
+    m_command_buffer = VK_NULL_HANDLE;
+}
+
+Buffer UploadContext::create_device_local_buffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage) {
+    Buffer buffer = create_buffer(*m_context, size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    upload(buffer.buffer, 0, data, size);
+
+    return buffer;
+}
+
+void UploadContext::upload(VkBuffer dst_buffer, VkDeviceSize dst_offset, const void* data, VkDeviceSize size) {
+    const auto* bytes = static_cast<const std::byte*>(data);
+
+    for (VkDeviceSize offset = 0; offset < size; offset += m_staging_buffer.size) {
+        VkDeviceSize chunk_size = std::min(m_staging_buffer.size, size - offset);
+
+        std::memcpy(m_staging_buffer.allocation.mapped, bytes + offset, static_cast<size_t>(chunk_size));
+        submit_copy(dst_buffer, dst_offset + offset, chunk_size);
+    }
+}
+
+void UploadContext::submit_copy(VkBuffer dst_buffer, VkDeviceSize dst_offset, VkDeviceSize size) {
+    VkDevice device = m_context->device();
+
+    vkResetCommandBuffer(m_command_buffer, 0);
+
+    VkCommandBufferBeginInfo command_buffer_begin_info{};
+    command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(m_command_buffer, &command_buffer_begin_info) != VK_SUCCESS) {
+        throw std::runtime_error("UploadContext::submit_copy => failed to begin recording command buffer!");
+    }
+
+    if (m_profiler != nullptr) {
+        m_profiler->begin(m_command_buffer, GpuProfiler::UPLOAD_SLOT, "upload");
+    }
+
+    VkBufferCopy copy_region{};
+    copy_region.srcOffset = 0;
+    copy_region.dstOffset = dst_offset;
+    copy_region.size      = size;
+    vkCmdCopyBuffer(m_command_buffer, m_staging_buffer.buffer, dst_buffer, 1, &copy_region);
+
+    if (m_profiler != nullptr) {
+        m_profiler->end(m_command_buffer, GpuProfiler::UPLOAD_SLOT);
+    }
+
+    if (vkEndCommandBuffer(m_command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("UploadContext::submit_copy => failed to record command buffer!");
+    }
+
+    VkSubmitInfo submit_info{};
+    submit_info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers    = &m_command_buffer;
+
+    if (vkQueueSubmit(m_queue, 1, &submit_info, m_fence) != VK_SUCCESS) {
+        throw std::runtime_error("UploadContext::submit_copy => failed to submit copy command buffer!");
+    }
+
+    // The staging buffer is reused by the next chunk, so the copy has to finish first.
+    vkWaitForFences(device, 1, &m_fence, VK_TRUE, UINT64_MAX);
+    vkResetFences(device, 1, &m_fence);
+
+    if (m_profiler != nullptr) {
+        m_profiler->collect(GpuProfiler::UPLOAD_SLOT);
+    }
+}
+
+}  // namespace renderer
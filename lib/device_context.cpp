@@ -0,0 +1,650 @@
+#include "device_context.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace renderer {
+
+namespace {
+
+/* ---- Debug messenger helpers and proxies ---- */
+
+// Returns true if the debug message is to aborted
+VKAPI_ATTR VkBool32 VKAPI_CALL debug_callback(VkDebugUtilsMessageSeverityFlagBitsEXT      message_severity,
+                                              VkDebugUtilsMessageTypeFlagsEXT             message_type,
+                                              const VkDebugUtilsMessengerCallbackDataEXT* ptr_callback_data,
+                                              void*                                       ptr_user_data) {
+    std::cerr << "Validation layer: " << ptr_callback_data->pMessage << " Severity: " << message_severity
+              << " Type: " << message_type << ptr_user_data << std::endl;
+
+    return VK_FALSE;
+}
+
+VkDebugUtilsMessengerCreateInfoEXT make_debug_messenger_create_info() {
+    VkDebugUtilsMessengerCreateInfoEXT create_info{};
+    create_info.sType           = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+    create_info.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT |
+                                  VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
+                                  VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+    create_info.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
+                              VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+                              VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+    create_info.pfnUserCallback = debug_callback;
+    create_info.pUserData       = nullptr;
+
+    return create_info;
+}
+
+VkResult proxy_create_debug_utils_messenger_ext(VkInstance                                instance,
+                                                const VkDebugUtilsMessengerCreateInfoEXT* ptr_create_info,
+                                                const VkAllocationCallbacks*              ptr_allocator,
+                                                VkDebugUtilsMessengerEXT*                 ptr_debug_messenger) {
+    auto func = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance, "vkCreateDebugUtilsMessengerEXT");
+    if (func != nullptr) {
+        return func(instance, ptr_create_info, ptr_allocator, ptr_debug_messenger);
+    } else {
+        return VK_ERROR_EXTENSION_NOT_PRESENT;
+    }
+}
+
+void proxy_destroy_debug_utils_messenger_ext(VkInstance instance, VkDebugUtilsMessengerEXT messenger,
+                                             const VkAllocationCallbacks* ptr_allocator) {
+    auto func =
+        (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT");
+    if (func != nullptr) {
+        func(instance, messenger, ptr_allocator);
+    }
+}
+
+}  // namespace
+
+void DeviceContext::init(const std::string& application_name, GLFWwindow* window) {
+    m_application_name = application_name;
+    m_window           = window;
+
+    // Headless contexts never present, so they must not require the swapchain extension.
+    if (headless()) {
+        m_device_extensions.clear();
+    }
+
+    create_instance();
+    check_extension_support();
+    setup_debug_messenger();
+
+    if (!headless()) {
+        create_surface();
+    }
+
+    pick_physical_device();
+    create_logical_device();
+    create_allocator();
+}
+
+void DeviceContext::cleanup() {
+    m_allocator.cleanup();
+    m_memory_backend.reset();
+
+    vkDestroyDevice(m_logical_device, nullptr);
+
+    if (ENABLE_VALIDATION_LAYERS) {
+        proxy_destroy_debug_utils_messenger_ext(m_instance, m_debug_messenger, nullptr);
+    }
+
+    if (m_surface != VK_NULL_HANDLE) {
+        vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+    }
+    vkDestroyInstance(m_instance, nullptr);
+
+    m_logical_device  = VK_NULL_HANDLE;
+    m_surface         = VK_NULL_HANDLE;
+    m_instance        = VK_NULL_HANDLE;
+    m_physical_device = VK_NULL_HANDLE;
+}
+
+SwapChainSupportDetails DeviceContext::query_swapchain_support_details() const {
+    return query_swapchain_support_details(m_physical_device);
+}
+
+uint32_t DeviceContext::find_memory_type(uint32_t type_filter, VkMemoryPropertyFlags properties) const {
+    return m_allocator.find_memory_type(type_filter, properties);
+}
+
+/* ---- Instance creation and validation layer helpers ---- */
+
+// Creates a vulkan instance
+// Creates vulcan create info
+// Sets up validation layers
+void DeviceContext::create_instance() {
+    if (ENABLE_VALIDATION_LAYERS && !(check_validation_layer_support())) {
+        throw std::runtime_error(
+            "DeviceContext::create_instance => validation layers "
+            "requested, but not available.");
+    }
+
+    m_instance_version = negotiate_instance_version();
+
+    VkApplicationInfo application_info{};
+    application_info.sType              = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    application_info.pApplicationName   = m_application_name.c_str();
+    application_info.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
+    application_info.pEngineName        = "no_engine";
+    application_info.engineVersion      = VK_MAKE_VERSION(1, 0, 0);
+    application_info.apiVersion         = m_instance_version;
+
+    VkInstanceCreateInfo application_create_info{};
+    application_create_info.sType            = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    application_create_info.pApplicationInfo = &application_info;
+
+    std::vector<const char*> required_extensions = get_required_extensions();
+
+    application_create_info.enabledExtensionCount   = static_cast<uint32_t>(required_extensions.size());
+    application_create_info.ppEnabledExtensionNames = required_extensions.data();
+
+    VkDebugUtilsMessengerCreateInfoEXT debug_messenger_create_info{};
+    if (ENABLE_VALIDATION_LAYERS) {
+        application_create_info.enabledLayerCount   = static_cast<uint32_t>(m_validation_layers.size());
+        application_create_info.ppEnabledLayerNames = m_validation_layers.data();
+
+        debug_messenger_create_info   = make_debug_messenger_create_info();
+        application_create_info.pNext = &debug_messenger_create_info;
+    } else {
+        application_create_info.enabledLayerCount = 0;
+        application_create_info.pNext             = nullptr;
+    }
+
+    if (vkCreateInstance(&application_create_info, nullptr, &m_instance) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "DeviceContext::create_instance => Failed to create a "
+            "Vulkan instance.");
+    }
+}
+
+// A 1.0 loader does not export vkEnumerateInstanceVersion and rejects any apiVersion above 1.0, so the
+// instance asks for min(loader version, TARGET_API_VERSION).
+uint32_t DeviceContext::negotiate_instance_version() {
+    auto enumerate_instance_version =
+        (PFN_vkEnumerateInstanceVersion)vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion");
+
+    uint32_t loader_version = VK_API_VERSION_1_0;
+    if (enumerate_instance_version == nullptr || enumerate_instance_version(&loader_version) != VK_SUCCESS) {
+        return VK_API_VERSION_1_0;
+    }
+
+    return std::min(loader_version, TARGET_API_VERSION);
+}
+
+void DeviceContext::check_extension_support() {
+    uint32_t count = 0;
+    vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+
+    std::vector<VkExtensionProperties> extensions(count);
+    vkEnumerateInstanceExtensionProperties(nullptr, &count, extensions.data());
+
+    std::cout << "DeviceContext::check_extension_support => Available extensions:\n";
+    for (const auto& extension : extensions) {
+        std::cout << '\t' << extension.extensionName << '\n';
+    }
+}
+
+bool DeviceContext::check_validation_layer_support() {
+    uint32_t count;
+    vkEnumerateInstanceLayerProperties(&count, nullptr);
+
+    std::vector<VkLayerProperties> available_layers(count);
+    vkEnumerateInstanceLayerProperties(&count, available_layers.data());
+
+    for (const char* layer_name : m_validation_layers) {
+        bool layer_found = false;
+
+        for (const auto& layer_properties : available_layers) {
+            if (std::strcmp(layer_name, layer_properties.layerName) == 0) {
+                layer_found = true;
+                break;
+            }
+        }
+
+        if (!layer_found) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::vector<const char*> DeviceContext::get_required_extensions() {
+    std::vector<const char*> vulkan_extensions;
+
+    // Headless mode never creates a surface, so it does not need the window system extensions.
+    if (!headless()) {
+        uint32_t     glfw_extion_count = 0;
+        const char** glfw_extensions;
+
+        glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extion_count);
+        vulkan_extensions.assign(glfw_extensions, glfw_extensions + glfw_extion_count);
+    }
+
+    if (ENABLE_VALIDATION_LAYERS) {
+        vulkan_extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    };
+
+    return vulkan_extensions;
+}
+
+void DeviceContext::setup_debug_messenger() {
+    if (!ENABLE_VALIDATION_LAYERS) {
+        return;
+    }
+
+    VkDebugUtilsMessengerCreateInfoEXT create_info = make_debug_messenger_create_info();
+
+    if (proxy_create_debug_utils_messenger_ext(m_instance, &create_info, nullptr, &m_debug_messenger) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "DeviceContext::setup_debug_messenger => failed to set "
+            "up debug messenger.");
+    }
+}
+
+void DeviceContext::create_surface() {
+    if (glfwCreateWindowSurface(m_instance, m_window, nullptr, &m_surface) != VK_SUCCESS) {
+        throw std::runtime_error("DeviceContext::create_surface => failed to create window surface!");
+    }
+}
+
+/* ---- Physical and logical device selection ---- */
+
+void DeviceContext::pick_physical_device() {
+    uint32_t count = 0;
+    vkEnumeratePhysicalDevices(m_instance, &count, nullptr);
+
+    if (count == 0) {
+        throw std::runtime_error(
+            "DeviceContext::pick_physical_device => Failed to find GPUs with Vulkan "
+            "support.");
+    }
+
+    std::vector<VkPhysicalDevice> devices(count);
+    vkEnumeratePhysicalDevices(m_instance, &count, devices.data());
+
+    std::multimap<uint32_t, VkPhysicalDevice> candidates;
+
+    for (const auto& device : devices) {
+        uint32_t score = rate_physical_device(device);
+        candidates.insert(std::make_pair(score, device));
+    }
+
+    if (candidates.empty()) {
+        throw std::runtime_error("DeviceContext::pick_physical_device => Failed to find a suitable GPU.");
+    }
+
+    if (candidates.rbegin()->first > 0) {
+        m_physical_device = candidates.rbegin()->second;
+    } else {
+        throw std::runtime_error("DeviceContext::pick_physical_device => Failed to find a suitable GPU.");
+    }
+
+    if (m_physical_device == VK_NULL_HANDLE) {
+        throw std::runtime_error("DeviceContext::pick_physical_device => Failed to find a suitable GPU.");
+    }
+
+    m_queue_family_indices = find_queue_familiy_indices(m_physical_device);
+    negotiate_device_features();
+}
+
+uint32_t DeviceContext::rate_physical_device(VkPhysicalDevice device) {
+    VkPhysicalDeviceProperties properties;
+    VkPhysicalDeviceFeatures   features;
+
+    vkGetPhysicalDeviceFeatures(device, &features);
+    vkGetPhysicalDeviceProperties(device, &properties);
+
+    int score = 0;
+
+    if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
+        score += 1000;
+    }
+
+    score += properties.limits.maxImageDimension2D;
+
+    if (!features.geometryShader) {
+        return 0;
+    }
+
+    if (!is_physical_device_suitable(device)) {
+        return 0;
+    }
+
+    return score;
+}
+
+bool DeviceContext::is_physical_device_suitable(VkPhysicalDevice device) {
+    QueueFamilyIndices queue_family_indices = find_queue_familiy_indices(device);
+
+    bool are_extensions_supported = check_physical_device_extension_support(device);
+    bool is_swap_chain_adequate   = headless() || (are_extensions_supported && check_swapchain_support(device));
+
+    return queue_family_indices.is_complete() && queue_family_indices.compute_family.has_value() &&
+           are_extensions_supported && is_swap_chain_adequate;
+}
+
+bool DeviceContext::check_physical_device_extension_support(VkPhysicalDevice device) {
+    uint32_t extension_count;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
+
+    std::vector<VkExtensionProperties> available_extensions(extension_count);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, available_extensions.data());
+
+    std::set<std::string> required_extensions(m_device_extensions.begin(), m_device_extensions.end());
+
+    for (const auto& extension : available_extensions) {
+        required_extensions.erase(extension.extensionName);
+    }
+
+    return required_extensions.empty();
+}
+
+bool DeviceContext::check_swapchain_support(VkPhysicalDevice physical_device) {
+    SwapChainSupportDetails details = query_swapchain_support_details(physical_device);
+    return !details.formats.empty() && !details.present_modes.empty();
+}
+
+QueueFamilyIndices DeviceContext::find_queue_familiy_indices(VkPhysicalDevice physical_device) {
+    QueueFamilyIndices queue_family_indices{};
+
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, nullptr);
+
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, queue_families.data());
+
+    uint32_t i = 0;
+    for (const auto& queue_family : queue_families) {
+        if (queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+            queue_family_indices.graphics_family = i;
+        }
+
+        // Without a surface nothing is presented, the graphics queue stands in for the present queue.
+        if (headless()) {
+            queue_family_indices.present_family = queue_family_indices.graphics_family;
+        } else {
+            VkBool32 has_presentation_support = false;
+            vkGetPhysicalDeviceSurfaceSupportKHR(physical_device, i, m_surface, &has_presentation_support);
+            if (has_presentation_support) {
+                queue_family_indices.present_family = i;
+            }
+        }
+
+        if (queue_family_indices.is_complete()) {
+            break;
+        }
+
+        ++i;
+    }
+
+    if (queue_family_indices.is_complete()) {
+        queue_family_indices.compute_family  = find_compute_queue_family(physical_device);
+        queue_family_indices.transfer_family =
+            find_transfer_queue_family(physical_device, queue_family_indices.graphics_family);
+    }
+
+    return queue_family_indices;
+}
+
+// Prefers a family with compute but without graphics, which runs beside the graphics queue on most discrete GPUs.
+// Every device with graphics has at least one family that also supports compute, which is the fallback.
+std::optional<uint32_t> DeviceContext::find_compute_queue_family(VkPhysicalDevice physical_device) const {
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, nullptr);
+
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, queue_families.data());
+
+    std::optional<uint32_t> compute_family;
+    for (uint32_t i = 0; i < queue_family_count; ++i) {
+        VkQueueFlags flags = queue_families[i].queueFlags;
+
+        if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+            return i;
+        }
+        if ((flags & VK_QUEUE_COMPUTE_BIT) && !compute_family.has_value()) {
+            compute_family = i;
+        }
+    }
+
+    return compute_family;
+}
+
+// Transfer-only families (the DMA engines of discrete GPUs) copy without taking time from graphics or compute work;
+// a compute family without graphics is the next best thing. Graphics families always support transfers.
+std::optional<uint32_t> DeviceContext::find_transfer_queue_family(VkPhysicalDevice        physical_device,
+                                                                  std::optional<uint32_t> graphics_family) const {
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, nullptr);
+
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, queue_families.data());
+
+    std::optional<uint32_t> transfer_family;
+    for (uint32_t i = 0; i < queue_family_count; ++i) {
+        VkQueueFlags flags = queue_families[i].queueFlags;
+
+        if (flags & VK_QUEUE_GRAPHICS_BIT) {
+            continue;
+        }
+        if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & VK_QUEUE_COMPUTE_BIT)) {
+            return i;
+        }
+        if ((flags & (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT)) && !transfer_family.has_value()) {
+            transfer_family = i;
+        }
+    }
+
+    return transfer_family.has_value() ? transfer_family : graphics_family;
+}
+
+SwapChainSupportDetails DeviceContext::query_swapchain_support_details(VkPhysicalDevice physical_device) const {
+    SwapChainSupportDetails details;
+
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device, m_surface, &details.capabilities);
+
+    uint32_t format_count;
+    vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device, m_surface, &format_count, nullptr);
+
+    if (format_count != 0) {
+        details.formats.resize(format_count);
+        vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device, m_surface, &format_count, details.formats.data());
+    }
+
+    uint32_t present_mode_count;
+    vkGetPhysicalDeviceSurfacePresentModesKHR(physical_device, m_surface, &present_mode_count, nullptr);
+
+    if (present_mode_count != 0) {
+        details.present_modes.resize(present_mode_count);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(physical_device, m_surface, &present_mode_count,
+                                                  details.present_modes.data());
+    }
+
+    return details;
+}
+
+// Everything here is optional: a feature the instance or device cannot provide is left disabled and the
+// code using it takes its fallback path.
+void DeviceContext::negotiate_device_features() {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physical_device, &properties);
+
+    m_features             = {};
+    m_features.api_version = std::min(m_instance_version, properties.apiVersion);
+
+    if (m_features.api_version >= VK_API_VERSION_1_2) {
+        VkPhysicalDeviceVulkan12Features vulkan_12_features{};
+        vulkan_12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+        // The extension's requirements (depth/stencil resolve, create render pass 2) are core in 1.2.
+        const bool has_dynamic_rendering = has_device_extension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+
+        VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features{};
+        dynamic_rendering_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+        if (has_dynamic_rendering) {
+            vulkan_12_features.pNext = &dynamic_rendering_features;
+        }
+
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &vulkan_12_features;
+        vkGetPhysicalDeviceFeatures2(m_physical_device, &features);
+
+        m_features.timeline_semaphore  = vulkan_12_features.timelineSemaphore;
+        m_features.draw_indirect_count = vulkan_12_features.drawIndirectCount;
+
+        // What BindlessTable needs: runtime-sized arrays of storage buffers and sampled images, written while bound
+        // and only partially populated, and indexed in shaders with dynamically uniform (push constant) indices.
+        m_features.descriptor_indexing = vulkan_12_features.runtimeDescriptorArray &&
+                                         vulkan_12_features.descriptorBindingPartiallyBound &&
+                                         vulkan_12_features.descriptorBindingUpdateUnusedWhilePending &&
+                                         vulkan_12_features.descriptorBindingStorageBufferUpdateAfterBind &&
+                                         vulkan_12_features.descriptorBindingSampledImageUpdateAfterBind &&
+                                         features.features.shaderStorageBufferArrayDynamicIndexing &&
+                                         features.features.shaderSampledImageArrayDynamicIndexing;
+
+        m_features.dynamic_rendering = has_dynamic_rendering && dynamic_rendering_features.dynamicRendering;
+    }
+
+    VkPhysicalDeviceFeatures features;
+    vkGetPhysicalDeviceFeatures(m_physical_device, &features);
+    m_features.multi_draw_indirect          = features.multiDrawIndirect;
+    m_features.draw_indirect_first_instance = features.drawIndirectFirstInstance;
+
+    std::cout << "DeviceContext::negotiate_device_features => Vulkan " << VK_API_VERSION_MAJOR(m_features.api_version)
+              << '.' << VK_API_VERSION_MINOR(m_features.api_version)
+              << ", timeline semaphores: " << (m_features.timeline_semaphore ? "yes" : "no")
+              << ", multi draw indirect: " << (m_features.multi_draw_indirect ? "yes" : "no")
+              << ", indirect first instance: " << (m_features.draw_indirect_first_instance ? "yes" : "no")
+              << ", draw indirect count: " << (m_features.draw_indirect_count ? "yes" : "no")
+              << ", descriptor indexing: " << (m_features.descriptor_indexing ? "yes" : "no")
+              << ", dynamic rendering: " << (m_features.dynamic_rendering ? "yes" : "no") << '\n';
+}
+
+bool DeviceContext::has_device_extension(const char* extension_name) const {
+    uint32_t extension_count;
+    vkEnumerateDeviceExtensionProperties(m_physical_device, nullptr, &extension_count, nullptr);
+
+    std::vector<VkExtensionProperties> available_extensions(extension_count);
+    vkEnumerateDeviceExtensionProperties(m_physical_device, nullptr, &extension_count, available_extensions.data());
+
+    for (const auto& extension : available_extensions) {
+        if (std::string_view(extension.extensionName) == extension_name) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void DeviceContext::create_logical_device() {
+    std::vector<VkDeviceQueueCreateInfo> queue_create_infos{};
+    std::set<uint32_t>                   unique_queue_families = {m_queue_family_indices.graphics_family.value(),
+                                                                  m_queue_family_indices.present_family.value(),
+                                                                  m_queue_family_indices.compute_family.value(),
+                                                                  m_queue_family_indices.transfer_family.value()};
+
+    float queue_priority = 1.0f;
+
+    for (const uint32_t queue_family : unique_queue_families) {
+        VkDeviceQueueCreateInfo queue_create_info = {};
+        queue_create_info.sType                   = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queue_create_info.queueFamilyIndex        = queue_family;
+        queue_create_info.queueCount              = 1;
+        queue_create_info.pQueuePriorities        = &queue_priority;
+        queue_create_infos.push_back(queue_create_info);
+    }
+
+    VkPhysicalDeviceFeatures physical_device_features  = {};
+    physical_device_features.multiDrawIndirect         = m_features.multi_draw_indirect;
+    physical_device_features.drawIndirectFirstInstance = m_features.draw_indirect_first_instance;
+
+    if (m_features.descriptor_indexing) {
+        physical_device_features.shaderStorageBufferArrayDynamicIndexing = VK_TRUE;
+        physical_device_features.shaderSampledImageArrayDynamicIndexing  = VK_TRUE;
+    }
+
+    // Only chained on 1.2 devices, earlier ones do not know the structure.
+    VkPhysicalDeviceVulkan12Features vulkan_12_features = {};
+    vulkan_12_features.sType                            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan_12_features.timelineSemaphore                = m_features.timeline_semaphore;
+    vulkan_12_features.drawIndirectCount                = m_features.draw_indirect_count;
+
+    if (m_features.descriptor_indexing) {
+        vulkan_12_features.runtimeDescriptorArray                        = VK_TRUE;
+        vulkan_12_features.descriptorBindingPartiallyBound               = VK_TRUE;
+        vulkan_12_features.descriptorBindingUpdateUnusedWhilePending     = VK_TRUE;
+        vulkan_12_features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        vulkan_12_features.descriptorBindingSampledImageUpdateAfterBind  = VK_TRUE;
+    }
+
+    std::vector<const char*> device_extensions = m_device_extensions;
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features{};
+    dynamic_rendering_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    dynamic_rendering_features.dynamicRendering = VK_TRUE;
+
+    if (m_features.dynamic_rendering) {
+        device_extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        vulkan_12_features.pNext = &dynamic_rendering_features;
+    }
+
+    VkDeviceCreateInfo logical_device_create_info      = {};
+    logical_device_create_info.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    logical_device_create_info.queueCreateInfoCount    = static_cast<uint32_t>(queue_create_infos.size());
+    logical_device_create_info.pQueueCreateInfos       = queue_create_infos.data();
+    logical_device_create_info.pEnabledFeatures        = &physical_device_features;
+    logical_device_create_info.enabledExtensionCount   = static_cast<uint32_t>(device_extensions.size());
+    logical_device_create_info.ppEnabledExtensionNames = device_extensions.data();
+
+    if (m_features.api_version >= VK_API_VERSION_1_2) {
+        logical_device_create_info.pNext = &vulkan_12_features;
+    }
+
+    // Previous implementations of Vulkan made a distinction between instance and device
+    // specific validation layers. Backwards compatibility with older implementations of Vulkan.
+    if (ENABLE_VALIDATION_LAYERS) {
+        logical_device_create_info.enabledLayerCount   = static_cast<uint32_t>(m_validation_layers.size());
+        logical_device_create_info.ppEnabledLayerNames = m_validation_layers.data();
+    } else {
+        logical_device_create_info.enabledLayerCount   = 0;
+        logical_device_create_info.ppEnabledLayerNames = nullptr;
+    }
+
+    if (vkCreateDevice(m_physical_device, &logical_device_create_info, nullptr, &m_logical_device) != VK_SUCCESS) {
+        throw std::runtime_error("DeviceContext::create_logical_device => failed to create logical device!");
+    }
+
+    vkGetDeviceQueue(m_logical_device, m_queue_family_indices.graphics_family.value(), 0, &m_graphics_queue);
+    vkGetDeviceQueue(m_logical_device, m_queue_family_indices.present_family.value(), 0, &m_present_queue);
+    vkGetDeviceQueue(m_logical_device, m_queue_family_indices.compute_family.value(), 0, &m_compute_queue);
+    vkGetDeviceQueue(m_logical_device, m_queue_family_indices.transfer_family.value(), 0, &m_transfer_queue);
+
+    if (m_features.dynamic_rendering) {
+        m_cmd_begin_rendering =
+            (PFN_vkCmdBeginRenderingKHR)vkGetDeviceProcAddr(m_logical_device, "vkCmdBeginRenderingKHR");
+        m_cmd_end_rendering = (PFN_vkCmdEndRenderingKHR)vkGetDeviceProcAddr(m_logical_device, "vkCmdEndRenderingKHR");
+    }
+}
+
+void DeviceContext::create_allocator() {
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    vkGetPhysicalDeviceMemoryProperties(m_physical_device, &memory_properties);
+
+    VkPhysicalDeviceProperties device_properties;
+    vkGetPhysicalDeviceProperties(m_physical_device, &device_properties);
+
+    m_memory_backend = std::make_unique<VulkanMemoryBackend>(m_logical_device);
+    m_allocator.init(*m_memory_backend, memory_properties, device_properties.limits.bufferImageGranularity);
+}
+
+}  // namespace renderer
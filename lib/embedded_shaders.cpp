@@ -0,0 +1,38 @@
+#include <algorithm>
+
+#include "shader_archive.hpp"
+
+#ifdef EMBED_SHADERS
+#include "embedded_shader_data.hpp"  // generated into bin/<config>/generated by tools/shader_embed
+#endif
+
+namespace renderer {
+
+#ifdef EMBED_SHADERS
+
+std::span<const uint32_t> find_embedded_shader(std::string_view path) {
+    const std::string_view name = shader_name(path);
+
+    auto it = std::lower_bound(
+        std::begin(embedded::SHADERS), std::end(embedded::SHADERS), name,
+        [](const embedded::EmbeddedShader& shader, std::string_view value) { return shader.name < value; });
+    return it != std::end(embedded::SHADERS) && it->name == name ? it->code : std::span<const uint32_t>{};
+}
+
+size_t embedded_shader_count() {
+    return std::size(embedded::SHADERS);
+}
+
+#else
+
+std::span<const uint32_t> find_embedded_shader(std::string_view) {
+    return {};
+}
+
+size_t embedded_shader_count() {
+    return 0;
+}
+
+#endif
+
+}  // namespace renderer
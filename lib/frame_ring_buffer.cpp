@@ -0,0 +1,116 @@
+#include "frame_ring_buffer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+namespace renderer {
+
+namespace {
+
+// The classic PCIe BAR window is 256 MiB. A bigger DEVICE_LOCAL | HOST_VISIBLE heap means resizable BAR or unified
+// memory, where host writes land in video memory and the GPU reads the ring at full speed.
+constexpr VkDeviceSize SMALL_BAR_SIZE = 256 * 1024 * 1024;
+
+bool has_large_bar(VkPhysicalDevice physical_device) {
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
+
+    const VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                             VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+        const VkMemoryType& memory_type = memory_properties.memoryTypes[i];
+        if ((memory_type.propertyFlags & properties) == properties &&
+            memory_properties.memoryHeaps[memory_type.heapIndex].size > SMALL_BAR_SIZE) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}  // namespace
+
+void FrameRingBuffer::init(const DeviceContext& context, VkBufferUsageFlags usage, VkDeviceSize region_size) {
+    m_context      = &context;
+    m_usage        = usage;
+    m_device_local = has_large_bar(context.physical_device());
+    m_peak_used    = 0;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(context.physical_device(), &properties);
+
+    m_min_alignment = 1;
+    if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) {
+        m_min_alignment = std::max(m_min_alignment, properties.limits.minUniformBufferOffsetAlignment);
+    }
+    if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) {
+        m_min_alignment = std::max(m_min_alignment, properties.limits.minStorageBufferOffsetAlignment);
+    }
+
+    create_ring(region_size);
+    begin_frame(0);
+}
+
+void FrameRingBuffer::cleanup() {
+    destroy_buffer(*m_context, m_buffer);
+
+    m_region_size = 0;
+    m_head        = 0;
+}
+
+void FrameRingBuffer::begin_frame(uint32_t frame_index) {
+    m_peak_used   = std::max(m_peak_used, m_head.load(std::memory_order_relaxed));
+    m_frame_index = frame_index;
+    m_head.store(0, std::memory_order_relaxed);
+}
+
+void FrameRingBuffer::reserve(VkDeviceSize region_size) {
+    if (region_size <= m_region_size) {
+        return;
+    }
+
+    // Every region moves, so the frames in flight have to be done with the old buffer.
+    vkDeviceWaitIdle(m_context->device());
+    destroy_buffer(*m_context, m_buffer);
+
+    create_ring(std::max(region_size, m_region_size * 2));
+}
+
+FrameRingAllocation FrameRingBuffer::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+    alignment = std::max(alignment, m_min_alignment);
+
+    // Aligned in buffer offsets rather than region offsets, so alignments that do not divide the region size work too.
+    const VkDeviceSize region_offset = VkDeviceSize{m_frame_index} * m_region_size;
+
+    VkDeviceSize head   = m_head.load(std::memory_order_relaxed);
+    VkDeviceSize offset = 0;
+    do {
+        offset = (region_offset + head + alignment - 1) / alignment * alignment;
+        if (offset + size > region_offset + m_region_size) {
+            throw std::runtime_error("FrameRingBuffer::allocate => frame region exhausted, reserve a larger one!");
+        }
+    } while (!m_head.compare_exchange_weak(head, offset + size - region_offset, std::memory_order_relaxed));
+
+    FrameRingAllocation allocation{};
+    allocation.buffer = m_buffer.buffer;
+    allocation.offset = offset;
+    allocation.data   = static_cast<std::byte*>(m_buffer.allocation.mapped) + offset;
+
+    return allocation;
+}
+
+void FrameRingBuffer::create_ring(VkDeviceSize region_size) {
+    m_region_size = (region_size + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT * REGION_ALIGNMENT;
+
+    VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    if (m_device_local) {
+        properties |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    }
+
+    m_buffer = renderer::create_buffer(*m_context, m_region_size * MAX_FRAMES_IN_FLIGHT, m_usage, properties);
+    m_head.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace renderer
@@ -0,0 +1,230 @@
+#include "frame_tracer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+#include <string_view>
+
+namespace renderer {
+
+/* ---- LatencyHistogram ---- */
+
+void LatencyHistogram::record(uint64_t ns) {
+    ++m_buckets[bucket_index(ns)];
+    ++m_count;
+    m_total_ns += ns;
+    m_min_ns    = std::min(m_min_ns, ns);
+    m_max_ns    = std::max(m_max_ns, ns);
+}
+
+uint64_t LatencyHistogram::percentile_ns(double percentile) const {
+    if (m_count == 0) {
+        return 0;
+    }
+
+    uint64_t target     = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(percentile / 100.0 * m_count)), 1);
+    uint64_t cumulative = 0;
+
+    for (uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+        cumulative += m_buckets[i];
+        if (cumulative >= target) {
+            return std::min(bucket_upper_bound(i), m_max_ns);
+        }
+    }
+
+    return m_max_ns;
+}
+
+uint32_t LatencyHistogram::bucket_index(uint64_t ns) {
+    if (ns < SUB_BUCKETS) {
+        return static_cast<uint32_t>(ns);
+    }
+
+    // Keep the SUB_BUCKET_BITS bits below the leading one; each shift step is a new power of two.
+    uint32_t shift = static_cast<uint32_t>(std::bit_width(ns)) - 1 - SUB_BUCKET_BITS;
+    uint32_t sub   = static_cast<uint32_t>(ns >> shift) - SUB_BUCKETS;
+
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(uint32_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+
+    uint32_t shift = index / SUB_BUCKETS - 1;
+    uint64_t sub   = index % SUB_BUCKETS;
+
+    return ((SUB_BUCKETS + sub) << shift) + ((uint64_t{1} << shift) - 1);
+}
+
+/* ---- FrameTracer ---- */
+
+FrameTracer::Scope::Scope(FrameTracer* tracer, const char* name) : m_tracer(tracer), m_name(name) {
+    if (m_tracer != nullptr) {
+        m_start_ns = m_tracer->now_ns();
+    }
+}
+
+void FrameTracer::Scope::end() {
+    if (m_tracer != nullptr) {
+        m_tracer->record(m_name, m_start_ns, m_tracer->now_ns());
+        m_tracer = nullptr;
+    }
+}
+
+void FrameTracer::init(const std::string& trace_path) {
+    static std::atomic<uint64_t> next_id = 1;
+
+    m_id    = next_id.fetch_add(1, std::memory_order_relaxed);
+    m_epoch = std::chrono::steady_clock::now();
+
+    if (!trace_path.empty()) {
+        m_trace.open(trace_path, std::ios::trunc);
+        if (!m_trace.is_open()) {
+            throw std::runtime_error("FrameTracer::init => failed to open trace file " + trace_path);
+        }
+
+        // Timestamps are in microseconds; keep sub-microsecond resolution regardless of their magnitude.
+        m_trace << std::fixed << std::setprecision(3) << "[\n";
+    }
+}
+
+void FrameTracer::cleanup() {
+    drain();
+
+    if (m_trace.is_open()) {
+        m_trace << "\n]\n";
+        m_trace.close();
+    }
+
+    // Threads that still cache a ring of this tracer see the id change and register again.
+    std::lock_guard<std::mutex> lock(m_rings_mutex);
+    m_rings.clear();
+    m_id = 0;
+}
+
+uint64_t FrameTracer::now_ns() const {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count());
+}
+
+void FrameTracer::record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+    Ring&    ring  = thread_ring();
+    uint64_t head  = ring.head.load(std::memory_order_relaxed);
+    uint64_t index = head & (RING_CAPACITY - 1);
+
+    ring.names[index].store(name, std::memory_order_relaxed);
+    ring.starts_ns[index].store(start_ns, std::memory_order_relaxed);
+    ring.durations_ns[index].store(end_ns - start_ns, std::memory_order_relaxed);
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void FrameTracer::drain() {
+    class Event {
+       public:
+        const char* name        = nullptr;
+        uint64_t    start_ns    = 0;
+        uint64_t    duration_ns = 0;
+        uint64_t    sequence    = 0;
+    };
+
+    std::lock_guard<std::mutex> lock(m_rings_mutex);
+    std::vector<Event>          events;
+
+    for (const std::unique_ptr<Ring>& ring : m_rings) {
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        if (head - ring->tail > RING_CAPACITY) {
+            m_dropped += head - RING_CAPACITY - ring->tail;
+            ring->tail = head - RING_CAPACITY;
+        }
+
+        events.clear();
+        for (uint64_t sequence = ring->tail; sequence < head; ++sequence) {
+            uint64_t index = sequence & (RING_CAPACITY - 1);
+            events.push_back({ring->names[index].load(std::memory_order_relaxed),
+                              ring->starts_ns[index].load(std::memory_order_relaxed),
+                              ring->durations_ns[index].load(std::memory_order_relaxed), sequence});
+        }
+        ring->tail = head;
+
+        // Seqlock-style validation: the owner may have lapped the ring while it was being copied, in which case
+        // the slots of the oldest events were being overwritten and those copies cannot be trusted.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t head_after = ring->head.load(std::memory_order_relaxed);
+
+        for (const Event& event : events) {
+            if (event.sequence + RING_CAPACITY <= head_after) {
+                ++m_dropped;
+                continue;
+            }
+
+            auto histogram = m_histograms.find(std::string_view(event.name));
+            if (histogram == m_histograms.end()) {
+                histogram = m_histograms.emplace(event.name, LatencyHistogram{}).first;
+            }
+            histogram->second.record(event.duration_ns);
+
+            write_trace_event(event.name, ring->thread_index, event.start_ns, event.duration_ns);
+        }
+    }
+}
+
+void FrameTracer::print_report(std::ostream& out) const {
+    if (m_histograms.empty()) {
+        return;
+    }
+
+    out << "FrameTracer => CPU stage latencies";
+    if (m_dropped > 0) {
+        out << ", " << m_dropped << " events dropped (ring overflow)";
+    }
+    out << '\n';
+
+    auto ms = [](uint64_t ns) { return static_cast<double>(ns) / 1'000'000.0; };
+
+    for (const auto& [name, histogram] : m_histograms) {
+        out << '\t' << name << ": n " << histogram.count() << ", avg " << histogram.mean_ns() / 1'000'000.0
+            << " ms, p50 " << ms(histogram.percentile_ns(50.0)) << " ms, p99 " << ms(histogram.percentile_ns(99.0))
+            << " ms, p999 " << ms(histogram.percentile_ns(99.9)) << " ms, max " << ms(histogram.max_ns()) << " ms\n";
+    }
+}
+
+FrameTracer::Ring& FrameTracer::thread_ring() {
+    class RingCache {
+       public:
+        uint64_t tracer_id = 0;
+        Ring*    ring      = nullptr;
+    };
+
+    // One cached ring per thread, so a thread should only record into one tracer at a time.
+    thread_local RingCache cache;
+    if (cache.tracer_id == m_id && cache.ring != nullptr) {
+        return *cache.ring;
+    }
+
+    std::lock_guard<std::mutex> lock(m_rings_mutex);
+    m_rings.push_back(std::make_unique<Ring>());
+    m_rings.back()->thread_index = static_cast<uint32_t>(m_rings.size() - 1);
+
+    cache.tracer_id = m_id;
+    cache.ring      = m_rings.back().get();
+
+    return *cache.ring;
+}
+
+void FrameTracer::write_trace_event(const char* name, uint32_t thread_index, uint64_t start_ns,
+                                    uint64_t duration_ns) {
+    if (!m_trace.is_open()) {
+        return;
+    }
+
+    m_trace << (m_trace_empty ? "" : ",\n") << "  {\"name\": \"" << name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": "
+            << thread_index << ", \"ts\": " << start_ns / 1000.0 << ", \"dur\": " << duration_ns / 1000.0 << "}";
+
+    m_trace_empty = false;
+}
+
+}  // namespace renderer
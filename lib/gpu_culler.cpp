@@ -0,0 +1,236 @@
+#include "gpu_culler.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+
+namespace renderer {
+
+void GpuCuller::init(const DeviceContext& context, VkPipelineCache pipeline_cache,
+                     const ShaderArchive* shader_archive) {
+    if (!supported(context)) {
+        throw std::runtime_error("GpuCuller::init => the device does not support drawIndirectFirstInstance!");
+    }
+
+    m_context    = &context;
+    m_compact    = context.features().draw_indirect_count;
+    m_multi_draw = context.features().multi_draw_indirect;
+
+    std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); ++i) {
+        bindings[i].binding         = i;
+        bindings[i].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo set_layout_create_info{};
+    set_layout_create_info.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    set_layout_create_info.bindingCount = static_cast<uint32_t>(bindings.size());
+    set_layout_create_info.pBindings    = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(context.device(), &set_layout_create_info, nullptr, &m_set_layout) !=
+        VK_SUCCESS) {
+        throw std::runtime_error("GpuCuller::init => failed to create descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize pool_size{};
+    pool_size.type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pool_size.descriptorCount = static_cast<uint32_t>(bindings.size()) * MAX_FRAMES_IN_FLIGHT;
+
+    VkDescriptorPoolCreateInfo descriptor_pool_create_info{};
+    descriptor_pool_create_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptor_pool_create_info.maxSets       = MAX_FRAMES_IN_FLIGHT;
+    descriptor_pool_create_info.poolSizeCount = 1;
+    descriptor_pool_create_info.pPoolSizes    = &pool_size;
+
+    if (vkCreateDescriptorPool(context.device(), &descriptor_pool_create_info, nullptr, &m_descriptor_pool) !=
+        VK_SUCCESS) {
+        throw std::runtime_error("GpuCuller::init => failed to create descriptor pool!");
+    }
+
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> set_layouts;
+    set_layouts.fill(m_set_layout);
+
+    VkDescriptorSetAllocateInfo descriptor_set_allocate_info{};
+    descriptor_set_allocate_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descriptor_set_allocate_info.descriptorPool     = m_descriptor_pool;
+    descriptor_set_allocate_info.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+    descriptor_set_allocate_info.pSetLayouts        = set_layouts.data();
+
+    if (vkAllocateDescriptorSets(context.device(), &descriptor_set_allocate_info, m_descriptor_sets.data()) !=
+        VK_SUCCESS) {
+        throw std::runtime_error("GpuCuller::init => failed to allocate descriptor sets!");
+    }
+
+    VkPushConstantRange push_constant_range{};
+    push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    push_constant_range.offset     = 0;
+    push_constant_range.size       = sizeof(PushConstants);
+
+    ComputePipelineDesc pipeline_desc{};
+    pipeline_desc.shader_path          = SHADER_PATH;
+    pipeline_desc.set_layouts          = {m_set_layout};
+    pipeline_desc.push_constant_ranges = {push_constant_range};
+
+    m_pipeline = create_compute_pipeline(context.device(), pipeline_desc, pipeline_cache, shader_archive);
+
+    std::cout << "GpuCuller::init => "
+              << (m_compact ? "compacted draws with a GPU draw count" : "one draw slot per object, no count buffer")
+              << (m_multi_draw ? "" : ", one vkCmdDrawIndexedIndirect per object (no multiDrawIndirect)") << '\n';
+}
+
+void GpuCuller::cleanup() {
+    destroy_buffers();
+
+    destroy_compute_pipeline(m_context->device(), m_pipeline);
+    vkDestroyDescriptorPool(m_context->device(), m_descriptor_pool, nullptr);
+    vkDestroyDescriptorSetLayout(m_context->device(), m_set_layout, nullptr);
+
+    m_descriptor_pool = VK_NULL_HANDLE;
+    m_set_layout      = VK_NULL_HANDLE;
+    m_descriptor_sets = {VK_NULL_HANDLE};
+}
+
+void GpuCuller::reserve(uint32_t object_count) {
+    if (object_count <= m_capacity) {
+        return;
+    }
+
+    // The old regions may still be read by frames in flight.
+    if (m_capacity > 0) {
+        vkDeviceWaitIdle(m_context->device());
+        destroy_buffers();
+    }
+
+    uint32_t capacity = std::max(object_count, m_capacity * 2);
+    capacity          = (capacity + CAPACITY_GRANULARITY - 1) / CAPACITY_GRANULARITY * CAPACITY_GRANULARITY;
+
+    create_buffers(capacity);
+    write_descriptor_sets();
+}
+
+math::Vec4* GpuCuller::bounds(uint32_t frame_index) const {
+    return static_cast<math::Vec4*>(m_bounds_buffer.allocation.mapped) + VkDeviceSize{frame_index} * m_capacity;
+}
+
+void GpuCuller::record_cull(VkCommandBuffer command_buffer, uint32_t frame_index, uint32_t object_count,
+                            const std::array<math::Vec4, 6>& frustum_planes, uint32_t index_count) {
+    const VkDeviceSize count_offset = VkDeviceSize{frame_index} * COUNT_REGION_SIZE;
+
+    if (m_compact) {
+        vkCmdFillBuffer(command_buffer, m_count_buffer.buffer, count_offset, sizeof(uint32_t), 0);
+
+        VkBufferMemoryBarrier count_barrier{};
+        count_barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        count_barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+        count_barrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        count_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        count_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        count_barrier.buffer              = m_count_buffer.buffer;
+        count_barrier.offset              = count_offset;
+        count_barrier.size                = sizeof(uint32_t);
+
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             0, nullptr, 1, &count_barrier, 0, nullptr);
+    }
+
+    PushConstants push_constants{};
+    push_constants.planes       = frustum_planes;
+    push_constants.object_count = object_count;
+    push_constants.index_count  = index_count;
+    push_constants.compact      = m_compact ? 1 : 0;
+
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline.pipeline);
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline.layout, 0, 1,
+                            &m_descriptor_sets[frame_index], 0, nullptr);
+    vkCmdPushConstants(command_buffer, m_pipeline.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants),
+                       &push_constants);
+    vkCmdDispatch(command_buffer, (object_count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+    // The draw commands and the count are read as indirect parameters by the render pass that follows.
+    VkMemoryBarrier draw_barrier{};
+    draw_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    draw_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    draw_barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+                         1, &draw_barrier, 0, nullptr, 0, nullptr);
+}
+
+void GpuCuller::record_draws(VkCommandBuffer command_buffer, uint32_t frame_index, uint32_t object_count) {
+    const VkDeviceSize draw_offset = draw_region_offset(frame_index);
+    const uint32_t     stride      = sizeof(VkDrawIndexedIndirectCommand);
+
+    if (m_compact) {
+        vkCmdDrawIndexedIndirectCount(command_buffer, m_draw_buffer.buffer, draw_offset, m_count_buffer.buffer,
+                                      VkDeviceSize{frame_index} * COUNT_REGION_SIZE, object_count, stride);
+    } else if (m_multi_draw) {
+        vkCmdDrawIndexedIndirect(command_buffer, m_draw_buffer.buffer, draw_offset, object_count, stride);
+    } else {
+        for (uint32_t i = 0; i < object_count; ++i) {
+            vkCmdDrawIndexedIndirect(command_buffer, m_draw_buffer.buffer, draw_offset + VkDeviceSize{i} * stride, 1,
+                                     stride);
+        }
+    }
+}
+
+void GpuCuller::create_buffers(uint32_t capacity) {
+    m_capacity = capacity;
+
+    m_bounds_buffer = create_buffer(*m_context, VkDeviceSize{MAX_FRAMES_IN_FLIGHT} * capacity * sizeof(math::Vec4),
+                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    m_draw_buffer   = create_buffer(*m_context, draw_region_offset(MAX_FRAMES_IN_FLIGHT),
+                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    m_count_buffer  = create_buffer(
+        *m_context, VkDeviceSize{MAX_FRAMES_IN_FLIGHT} * COUNT_REGION_SIZE,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+void GpuCuller::destroy_buffers() {
+    if (m_capacity == 0) {
+        return;
+    }
+
+    destroy_buffer(*m_context, m_count_buffer);
+    destroy_buffer(*m_context, m_draw_buffer);
+    destroy_buffer(*m_context, m_bounds_buffer);
+    m_capacity = 0;
+}
+
+void GpuCuller::write_descriptor_sets() {
+    for (uint32_t frame_index = 0; frame_index < MAX_FRAMES_IN_FLIGHT; ++frame_index) {
+        std::array<VkDescriptorBufferInfo, 3> buffer_infos{};
+        buffer_infos[0].buffer = m_bounds_buffer.buffer;
+        buffer_infos[0].offset = VkDeviceSize{frame_index} * m_capacity * sizeof(math::Vec4);
+        buffer_infos[0].range  = VkDeviceSize{m_capacity} * sizeof(math::Vec4);
+        buffer_infos[1].buffer = m_draw_buffer.buffer;
+        buffer_infos[1].offset = draw_region_offset(frame_index);
+        buffer_infos[1].range  = VkDeviceSize{m_capacity} * sizeof(VkDrawIndexedIndirectCommand);
+        buffer_infos[2].buffer = m_count_buffer.buffer;
+        buffer_infos[2].offset = VkDeviceSize{frame_index} * COUNT_REGION_SIZE;
+        buffer_infos[2].range  = sizeof(uint32_t);
+
+        std::array<VkWriteDescriptorSet, 3> writes{};
+        for (uint32_t i = 0; i < writes.size(); ++i) {
+            writes[i].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet          = m_descriptor_sets[frame_index];
+            writes[i].dstBinding      = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo     = &buffer_infos[i];
+        }
+
+        vkUpdateDescriptorSets(m_context->device(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+VkDeviceSize GpuCuller::draw_region_offset(uint32_t frame_index) const {
+    return VkDeviceSize{frame_index} * m_capacity * sizeof(VkDrawIndexedIndirectCommand);
+}
+
+}  // namespace renderer
@@ -0,0 +1,241 @@
+#include "gpu_profiler.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace renderer {
+
+void GpuProfiler::init(const DeviceContext& context, const std::string& trace_path) {
+    m_context = &context;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(context.physical_device(), &properties);
+
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(context.physical_device(), &queue_family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(context.physical_device(), &queue_family_count, queue_families.data());
+
+    uint32_t valid_bits = queue_families[context.queue_family_indices().graphics_family.value()].timestampValidBits;
+
+    // GPU times are optional, everything else keeps working on devices without timestamp support.
+    if (!properties.limits.timestampComputeAndGraphics || valid_bits == 0) {
+        std::cerr << "GpuProfiler::init => timestamps not supported, GPU times will not be reported.\n";
+        return;
+    }
+
+    m_enabled        = true;
+    m_ns_per_tick    = properties.limits.timestampPeriod;
+    m_timestamp_mask = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+
+    VkQueryPoolCreateInfo query_pool_create_info{};
+    query_pool_create_info.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    query_pool_create_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+    query_pool_create_info.queryCount = MAX_SCOPES * 2;
+
+    for (Slot& slot : m_slots) {
+        if (vkCreateQueryPool(context.device(), &query_pool_create_info, nullptr, &slot.query_pool) != VK_SUCCESS) {
+            throw std::runtime_error("GpuProfiler::init => failed to create query pool!");
+        }
+        slot.scopes.reserve(MAX_SCOPES);
+    }
+
+    if (!trace_path.empty()) {
+        m_trace.open(trace_path, std::ios::trunc);
+        if (!m_trace.is_open()) {
+            throw std::runtime_error("GpuProfiler::init => failed to open trace file " + trace_path);
+        }
+
+        m_trace_json = trace_path.ends_with(".json");
+        m_trace << (m_trace_json ? "[\n" : "sequence,scope,depth,start_ms,duration_ms\n");
+    }
+}
+
+void GpuProfiler::cleanup() {
+    for (Slot& slot : m_slots) {
+        if (slot.query_pool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(m_context->device(), slot.query_pool, nullptr);
+        }
+        slot = {};
+    }
+
+    if (m_trace.is_open()) {
+        if (m_trace_json) {
+            m_trace << "\n]\n";
+        }
+        m_trace.close();
+    }
+
+    m_enabled = false;
+}
+
+void GpuProfiler::begin(VkCommandBuffer command_buffer, uint32_t slot_index, const char* root_name) {
+    if (!m_enabled) {
+        return;
+    }
+
+    Slot& slot = m_slots[slot_index];
+    slot.scopes.clear();
+    slot.next_query = 0;
+    slot.depth      = 0;
+    slot.pending    = false;
+
+    vkCmdResetQueryPool(command_buffer, slot.query_pool, 0, MAX_SCOPES * 2);
+    begin_scope(command_buffer, slot_index, root_name);
+}
+
+void GpuProfiler::end(VkCommandBuffer command_buffer, uint32_t slot_index) {
+    if (!m_enabled) {
+        return;
+    }
+
+    end_scope(command_buffer, slot_index, 0);
+    m_slots[slot_index].pending = true;
+}
+
+uint32_t GpuProfiler::begin_scope(VkCommandBuffer command_buffer, uint32_t slot_index, const char* name) {
+    Slot& slot = m_slots[slot_index];
+    if (!m_enabled || slot.scopes.size() == MAX_SCOPES) {
+        return MAX_SCOPES;
+    }
+
+    PendingScope scope{};
+    scope.name        = name;
+    scope.depth       = slot.depth++;
+    scope.begin_query = slot.next_query++;
+    scope.end_query   = slot.next_query++;
+    slot.scopes.push_back(scope);
+
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.query_pool, scope.begin_query);
+
+    return static_cast<uint32_t>(slot.scopes.size() - 1);
+}
+
+void GpuProfiler::end_scope(VkCommandBuffer command_buffer, uint32_t slot_index, uint32_t scope) {
+    Slot& slot = m_slots[slot_index];
+    if (!m_enabled || scope >= slot.scopes.size()) {
+        return;
+    }
+
+    --slot.depth;
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, slot.query_pool,
+                        slot.scopes[scope].end_query);
+}
+
+const GpuFrameProfile* GpuProfiler::collect(uint32_t slot_index) {
+    Slot& slot = m_slots[slot_index];
+    if (!m_enabled || !slot.pending) {
+        return nullptr;
+    }
+    slot.pending = false;
+
+    // Each query yields {timestamp, availability}. Never wait: a result that is not there yet is dropped.
+    std::vector<uint64_t> results(slot.next_query * 2);
+    VkResult              result = vkGetQueryPoolResults(
+        m_context->device(), slot.query_pool, 0, slot.next_query, results.size() * sizeof(uint64_t), results.data(),
+        2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+    bool available = result == VK_SUCCESS || result == VK_NOT_READY;
+    for (uint32_t i = 0; available && i < slot.next_query; ++i) {
+        available = results[i * 2 + 1] != 0;
+    }
+
+    if (!available) {
+        ++m_missed;
+        return nullptr;
+    }
+
+    auto ticks_to_ms = [this](uint64_t begin, uint64_t end) {
+        return static_cast<double>((end - begin) & m_timestamp_mask) * m_ns_per_tick / 1'000'000.0;
+    };
+
+    const uint64_t root_begin = results[slot.scopes[0].begin_query * 2];
+
+    m_last_profile.sequence = m_sequence++;
+    m_last_profile.scopes.clear();
+
+    for (const PendingScope& scope : slot.scopes) {
+        GpuScopeSample sample{};
+        sample.name        = scope.name;
+        sample.depth       = scope.depth;
+        sample.start_ms    = ticks_to_ms(root_begin, results[scope.begin_query * 2]);
+        sample.duration_ms = ticks_to_ms(results[scope.begin_query * 2], results[scope.end_query * 2]);
+        m_last_profile.scopes.push_back(sample);
+
+        ScopeWindow& window = m_windows[sample.name];
+        if (window.samples.size() < STATS_WINDOW) {
+            window.samples.push_back(sample.duration_ms);
+        } else {
+            window.samples[window.next] = sample.duration_ms;
+        }
+        window.next = (window.next + 1) % STATS_WINDOW;
+        ++window.count;
+    }
+
+    write_trace(m_last_profile);
+    return &m_last_profile;
+}
+
+std::map<std::string, GpuScopeStats> GpuProfiler::stats() const {
+    std::map<std::string, GpuScopeStats> stats;
+
+    for (const auto& [name, window] : m_windows) {
+        GpuScopeStats& scope_stats = stats[name];
+        scope_stats.count          = window.count;
+        scope_stats.last_ms        = window.samples[(window.next + window.samples.size() - 1) % window.samples.size()];
+        scope_stats.min_ms         = *std::min_element(window.samples.begin(), window.samples.end());
+        scope_stats.max_ms         = *std::max_element(window.samples.begin(), window.samples.end());
+
+        double total = 0.0;
+        for (double sample : window.samples) {
+            total += sample;
+        }
+        scope_stats.avg_ms = total / window.samples.size();
+    }
+
+    return stats;
+}
+
+void GpuProfiler::print_stats(std::ostream& out) const {
+    if (!m_enabled) {
+        return;
+    }
+
+    out << "GpuProfiler => last " << STATS_WINDOW << " samples per scope";
+    if (m_missed > 0) {
+        out << ", " << m_missed << " frames dropped (results not available)";
+    }
+    out << '\n';
+
+    for (const auto& [name, scope_stats] : stats()) {
+        out << '\t' << name << ": avg " << scope_stats.avg_ms << " ms, min " << scope_stats.min_ms << " ms, max "
+            << scope_stats.max_ms << " ms (" << scope_stats.count << " samples)\n";
+    }
+}
+
+void GpuProfiler::write_trace(const GpuFrameProfile& profile) {
+    if (!m_trace.is_open()) {
+        return;
+    }
+
+    if (!m_trace_json) {
+        for (const GpuScopeSample& sample : profile.scopes) {
+            m_trace << profile.sequence << ',' << sample.name << ',' << sample.depth << ',' << sample.start_ms << ','
+                    << sample.duration_ms << '\n';
+        }
+        return;
+    }
+
+    m_trace << (m_trace_empty ? "" : ",\n") << "  {\"sequence\": " << profile.sequence << ", \"scopes\": [";
+    for (size_t i = 0; i < profile.scopes.size(); ++i) {
+        const GpuScopeSample& sample = profile.scopes[i];
+        m_trace << (i == 0 ? "" : ", ") << "{\"name\": \"" << sample.name << "\", \"depth\": " << sample.depth
+                << ", \"start_ms\": " << sample.start_ms << ", \"duration_ms\": " << sample.duration_ms << "}";
+    }
+    m_trace << "]}";
+
+    m_trace_empty = false;
+}
+
+}  // namespace renderer
@@ -0,0 +1,101 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace renderer {
+
+void JobSystem::init(uint32_t worker_count) {
+    m_stopping   = false;
+    m_generation = 0;
+
+    for (uint32_t i = 1; i < std::max(worker_count, 1u); ++i) {
+        m_threads.emplace_back(&JobSystem::worker_main, this, i);
+    }
+}
+
+void JobSystem::cleanup() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+
+    m_threads.clear();
+}
+
+void JobSystem::dispatch(uint32_t job_count, const Job& job) {
+    if (m_threads.empty() || job_count <= 1) {
+        for (uint32_t i = 0; i < job_count; ++i) {
+            job(i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job             = &job;
+        m_job_count       = job_count;
+        m_pending_workers = static_cast<uint32_t>(m_threads.size());
+        m_exception       = nullptr;
+        m_next_job.store(0, std::memory_order_relaxed);
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    run_jobs(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending_workers == 0; });
+
+    m_job = nullptr;
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void JobSystem::worker_main(uint32_t worker_index) {
+    uint64_t seen_generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seen_generation; });
+
+            if (m_stopping) {
+                return;
+            }
+            seen_generation = m_generation;
+        }
+
+        run_jobs(worker_index);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending_workers == 0) {
+            m_done.notify_one();
+        }
+    }
+}
+
+void JobSystem::run_jobs(uint32_t worker_index) {
+    try {
+        for (uint32_t i = m_next_job.fetch_add(1, std::memory_order_relaxed); i < m_job_count;
+             i = m_next_job.fetch_add(1, std::memory_order_relaxed)) {
+            (*m_job)(i, worker_index);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_exception) {
+            m_exception = std::current_exception();
+        }
+
+        // Drain the remaining jobs so every worker stops early.
+        m_next_job.store(m_job_count, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace renderer
@@ -0,0 +1,225 @@
+#include "math.hpp"
+
+#include <algorithm>
+
+#include "simd.hpp"
+
+namespace math {
+
+namespace {
+
+#if defined(MATH_SIMD_AVX2) || defined(MATH_SIMD_SSE)
+
+// m * v as a sum of the columns scaled by broadcast components.
+inline __m128 transform_sse(const __m128 columns[4], __m128 v) {
+    __m128 result = _mm_mul_ps(columns[0], _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+    result        = _mm_add_ps(result, _mm_mul_ps(columns[1], _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+    result        = _mm_add_ps(result, _mm_mul_ps(columns[2], _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+    result        = _mm_add_ps(result, _mm_mul_ps(columns[3], _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+    return result;
+}
+
+inline void load_columns_sse(const Mat4& m, __m128 columns[4]) {
+    for (int i = 0; i < 4; ++i) {
+        columns[i] = _mm_load_ps(&m.columns[i].x);
+    }
+}
+
+#endif
+
+#if defined(MATH_SIMD_AVX2)
+
+inline __m256 multiply_add_avx(__m256 a, __m256 b, __m256 c) {
+#if defined(__FMA__)
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+// Transforms two vec4s at once: each 128-bit lane holds one vector and a copy of every column.
+inline __m256 transform_avx(const __m256 columns[4], __m256 v) {
+    __m256 result = _mm256_mul_ps(columns[0], _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)));
+    result        = multiply_add_avx(columns[1], _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), result);
+    result        = multiply_add_avx(columns[2], _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), result);
+    result        = multiply_add_avx(columns[3], _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), result);
+    return result;
+}
+
+inline void load_columns_avx(const Mat4& m, __m256 columns[4]) {
+    for (int i = 0; i < 4; ++i) {
+        columns[i] = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m.columns[i].x));
+    }
+}
+
+// Columns 0/1 and 2/3 of b are transformed pairwise. Mat4 is only 16-byte aligned, hence the unaligned accesses.
+inline void multiply_avx(const Mat4& a, const Mat4& b, Mat4& out) {
+    __m256 columns[4];
+    load_columns_avx(a, columns);
+
+    _mm256_storeu_ps(&out.columns[0].x, transform_avx(columns, _mm256_loadu_ps(&b.columns[0].x)));
+    _mm256_storeu_ps(&out.columns[2].x, transform_avx(columns, _mm256_loadu_ps(&b.columns[2].x)));
+}
+
+#elif defined(MATH_SIMD_SSE)
+
+inline void multiply_sse(const Mat4& a, const Mat4& b, Mat4& out) {
+    __m128 columns[4];
+    load_columns_sse(a, columns);
+
+    for (int i = 0; i < 4; ++i) {
+        _mm_store_ps(&out.columns[i].x, transform_sse(columns, _mm_load_ps(&b.columns[i].x)));
+    }
+}
+
+#elif defined(MATH_SIMD_NEON)
+
+inline float32x4_t transform_neon(const float32x4_t columns[4], float32x4_t v) {
+    float32x4_t result = vmulq_laneq_f32(columns[0], v, 0);
+    result             = vfmaq_laneq_f32(result, columns[1], v, 1);
+    result             = vfmaq_laneq_f32(result, columns[2], v, 2);
+    result             = vfmaq_laneq_f32(result, columns[3], v, 3);
+    return result;
+}
+
+inline void load_columns_neon(const Mat4& m, float32x4_t columns[4]) {
+    for (int i = 0; i < 4; ++i) {
+        columns[i] = vld1q_f32(&m.columns[i].x);
+    }
+}
+
+inline void multiply_neon(const Mat4& a, const Mat4& b, Mat4& out) {
+    float32x4_t columns[4];
+    load_columns_neon(a, columns);
+
+    for (int i = 0; i < 4; ++i) {
+        vst1q_f32(&out.columns[i].x, transform_neon(columns, vld1q_f32(&b.columns[i].x)));
+    }
+}
+
+#endif
+
+inline void multiply_one(const Mat4& a, const Mat4& b, Mat4& out) {
+#if defined(MATH_SIMD_AVX2)
+    multiply_avx(a, b, out);
+#elif defined(MATH_SIMD_SSE)
+    multiply_sse(a, b, out);
+#elif defined(MATH_SIMD_NEON)
+    multiply_neon(a, b, out);
+#else
+    out = a * b;
+#endif
+}
+
+}  // namespace
+
+const char* simd_path() {
+#if defined(MATH_SIMD_AVX2)
+    return "avx2";
+#elif defined(MATH_SIMD_SSE)
+    return "sse";
+#elif defined(MATH_SIMD_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+void transform(const Mat4& m, std::span<const Vec4> in, std::span<Vec4> out) {
+    const size_t count = std::min(in.size(), out.size());
+    size_t       i     = 0;
+
+#if defined(MATH_SIMD_AVX2)
+    __m256 columns[4];
+    load_columns_avx(m, columns);
+
+    // Vec4 is only 16-byte aligned, so pairs of them need unaligned 256-bit loads and stores.
+    for (; i + 2 <= count; i += 2) {
+        __m256 v = _mm256_loadu_ps(&in[i].x);
+        _mm256_storeu_ps(&out[i].x, transform_avx(columns, v));
+    }
+
+    if (i < count) {
+        __m128 sse_columns[4];
+        load_columns_sse(m, sse_columns);
+        _mm_store_ps(&out[i].x, transform_sse(sse_columns, _mm_load_ps(&in[i].x)));
+    }
+#elif defined(MATH_SIMD_SSE)
+    __m128 columns[4];
+    load_columns_sse(m, columns);
+
+    for (; i < count; ++i) {
+        _mm_store_ps(&out[i].x, transform_sse(columns, _mm_load_ps(&in[i].x)));
+    }
+#elif defined(MATH_SIMD_NEON)
+    float32x4_t columns[4];
+    load_columns_neon(m, columns);
+
+    for (; i < count; ++i) {
+        vst1q_f32(&out[i].x, transform_neon(columns, vld1q_f32(&in[i].x)));
+    }
+#else
+    for (; i < count; ++i) {
+        out[i] = m * in[i];
+    }
+#endif
+}
+
+void multiply(std::span<const Mat4> a, std::span<const Mat4> b, std::span<Mat4> out) {
+    const size_t count = std::min({a.size(), b.size(), out.size()});
+
+    for (size_t i = 0; i < count; ++i) {
+        multiply_one(a[i], b[i], out[i]);
+    }
+}
+
+void multiply(const Mat4& a, std::span<const Mat4> b, std::span<Mat4> out) {
+    const size_t count = std::min(b.size(), out.size());
+
+#if defined(MATH_SIMD_AVX2)
+    // a is loaded once for the whole batch instead of once per matrix.
+    __m256 columns[4];
+    load_columns_avx(a, columns);
+
+    for (size_t i = 0; i < count; ++i) {
+        _mm256_storeu_ps(&out[i].columns[0].x, transform_avx(columns, _mm256_loadu_ps(&b[i].columns[0].x)));
+        _mm256_storeu_ps(&out[i].columns[2].x, transform_avx(columns, _mm256_loadu_ps(&b[i].columns[2].x)));
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        multiply_one(a, b[i], out[i]);
+    }
+#endif
+}
+
+/* ---- Scalar reference kernels ---- */
+
+namespace scalar {
+
+void transform(const Mat4& m, std::span<const Vec4> in, std::span<Vec4> out) {
+    const size_t count = std::min(in.size(), out.size());
+
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = m * in[i];
+    }
+}
+
+void multiply(std::span<const Mat4> a, std::span<const Mat4> b, std::span<Mat4> out) {
+    const size_t count = std::min({a.size(), b.size(), out.size()});
+
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+void multiply(const Mat4& a, std::span<const Mat4> b, std::span<Mat4> out) {
+    const size_t count = std::min(b.size(), out.size());
+
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = a * b[i];
+    }
+}
+
+}  // namespace scalar
+
+}  // namespace math
@@ -0,0 +1,141 @@
+#include "parallel_recorder.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace renderer {
+
+void ParallelRecorder::init(const DeviceContext& context, JobSystem& job_system) {
+    m_context    = &context;
+    m_job_system = &job_system;
+
+    create_worker_pools();
+}
+
+void ParallelRecorder::cleanup() {
+    destroy_worker_pools();
+    m_recorded.clear();
+}
+
+const std::vector<VkCommandBuffer>& ParallelRecorder::record(uint32_t frame_index, VkRenderPass render_pass,
+                                                             VkFramebuffer framebuffer, uint32_t draw_count,
+                                                             const RecordRange& record_range) {
+    VkCommandBufferInheritanceInfo inheritance_info{};
+    inheritance_info.sType       = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance_info.renderPass  = render_pass;
+    inheritance_info.subpass     = 0;
+    inheritance_info.framebuffer = framebuffer;
+
+    return record_inherited(frame_index, inheritance_info, draw_count, record_range);
+}
+
+const std::vector<VkCommandBuffer>& ParallelRecorder::record(uint32_t frame_index,
+                                                             const RenderPassLayout& render_pass_layout,
+                                                             uint32_t draw_count, const RecordRange& record_range) {
+    VkCommandBufferInheritanceRenderingInfoKHR rendering_inheritance_info{};
+    rendering_inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+    rendering_inheritance_info.colorAttachmentCount    = 1;
+    rendering_inheritance_info.pColorAttachmentFormats = &render_pass_layout.color_format;
+    rendering_inheritance_info.rasterizationSamples    = render_pass_layout.samples;
+
+    VkCommandBufferInheritanceInfo inheritance_info{};
+    inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance_info.pNext = &rendering_inheritance_info;
+
+    return record_inherited(frame_index, inheritance_info, draw_count, record_range);
+}
+
+const std::vector<VkCommandBuffer>& ParallelRecorder::record_inherited(
+    uint32_t frame_index, const VkCommandBufferInheritanceInfo& inheritance_info, uint32_t draw_count,
+    const RecordRange& record_range) {
+    VkDevice                 device       = m_context->device();
+    std::vector<WorkerPool>& worker_pools = m_worker_pools[frame_index];
+
+    // One reset per worker pool recycles every secondary buffer recorded for this frame slot last time.
+    for (WorkerPool& worker_pool : worker_pools) {
+        vkResetCommandPool(device, worker_pool.command_pool, 0);
+        worker_pool.used = 0;
+    }
+
+    uint32_t max_jobs  = m_job_system->worker_count() * JOBS_PER_WORKER;
+    uint32_t job_count = std::clamp(draw_count / MIN_DRAWS_PER_JOB, 1u, max_jobs);
+    m_recorded.assign(job_count, VK_NULL_HANDLE);
+
+    VkCommandBufferBeginInfo command_buffer_begin_info{};
+    command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    command_buffer_begin_info.flags =
+        VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    command_buffer_begin_info.pInheritanceInfo = &inheritance_info;
+
+    m_job_system->dispatch(job_count, [&](uint32_t job_index, uint32_t worker_index) {
+        uint32_t first_draw = static_cast<uint32_t>(uint64_t{draw_count} * job_index / job_count);
+        uint32_t last_draw  = static_cast<uint32_t>(uint64_t{draw_count} * (job_index + 1) / job_count);
+
+        VkCommandBuffer command_buffer = acquire_command_buffer(worker_pools[worker_index]);
+
+        if (vkBeginCommandBuffer(command_buffer, &command_buffer_begin_info) != VK_SUCCESS) {
+            throw std::runtime_error("ParallelRecorder::record => failed to begin secondary command buffer!");
+        }
+
+        record_range(command_buffer, first_draw, last_draw - first_draw);
+
+        if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+            throw std::runtime_error("ParallelRecorder::record => failed to record secondary command buffer!");
+        }
+
+        m_recorded[job_index] = command_buffer;
+    });
+
+    return m_recorded;
+}
+
+void ParallelRecorder::create_worker_pools() {
+    VkCommandPoolCreateInfo command_pool_create_info{};
+    command_pool_create_info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    command_pool_create_info.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    command_pool_create_info.queueFamilyIndex = m_context->queue_family_indices().graphics_family.value();
+
+    for (std::vector<WorkerPool>& worker_pools : m_worker_pools) {
+        worker_pools.resize(m_job_system->worker_count());
+
+        for (WorkerPool& worker_pool : worker_pools) {
+            if (vkCreateCommandPool(m_context->device(), &command_pool_create_info, nullptr,
+                                    &worker_pool.command_pool) != VK_SUCCESS) {
+                throw std::runtime_error("ParallelRecorder::create_worker_pools => failed to create command pool!");
+            }
+        }
+    }
+}
+
+void ParallelRecorder::destroy_worker_pools() {
+    for (std::vector<WorkerPool>& worker_pools : m_worker_pools) {
+        // Destroying the pool frees its command buffers.
+        for (WorkerPool& worker_pool : worker_pools) {
+            vkDestroyCommandPool(m_context->device(), worker_pool.command_pool, nullptr);
+        }
+
+        worker_pools.clear();
+    }
+}
+
+VkCommandBuffer ParallelRecorder::acquire_command_buffer(WorkerPool& worker_pool) {
+    if (worker_pool.used == worker_pool.command_buffers.size()) {
+        VkCommandBufferAllocateInfo command_buffer_allocate_info{};
+        command_buffer_allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        command_buffer_allocate_info.commandPool        = worker_pool.command_pool;
+        command_buffer_allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        command_buffer_allocate_info.commandBufferCount = 1;
+
+        VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(m_context->device(), &command_buffer_allocate_info, &command_buffer) !=
+            VK_SUCCESS) {
+            throw std::runtime_error("ParallelRecorder::acquire_command_buffer => failed to allocate command buffer!");
+        }
+
+        worker_pool.command_buffers.push_back(command_buffer);
+    }
+
+    return worker_pool.command_buffers[worker_pool.used++];
+}
+
+}  // namespace renderer
@@ -0,0 +1,389 @@
+#include "pipeline.hpp"
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+#include "shader.hpp"
+#include "shader_archive.hpp"
+
+namespace renderer {
+
+namespace {
+
+// FNV-1a, fed one field at a time so struct padding never reaches the hash.
+class Hasher {
+   public:
+    uint64_t value = 14695981039346656037ull;
+
+    void add_bytes(const void* data, size_t size) {
+        const auto* bytes = static_cast<const std::byte*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            value ^= static_cast<uint64_t>(bytes[i]);
+            value *= 1099511628211ull;
+        }
+    }
+
+    template <typename T>
+    void add(const T& field) {
+        add_bytes(&field, sizeof(field));
+    }
+
+    void add(const std::string& string) {
+        add(string.size());
+        add_bytes(string.data(), string.size());
+    }
+};
+
+void hash_layout(Hasher& hasher, const std::vector<VkDescriptorSetLayout>& set_layouts,
+                 const std::vector<VkPushConstantRange>& push_constant_ranges) {
+    hasher.add(set_layouts.size());
+    for (VkDescriptorSetLayout set_layout : set_layouts) {
+        hasher.add(set_layout);
+    }
+
+    hasher.add(push_constant_ranges.size());
+    for (const VkPushConstantRange& range : push_constant_ranges) {
+        hasher.add(range.stageFlags);
+        hasher.add(range.offset);
+        hasher.add(range.size);
+    }
+}
+
+// Embedded code first (EMBED_SHADERS=1 builds), then the archive, then the file.
+ShaderBlob load_shader(const std::string& path, const ShaderArchive* shader_archive) {
+    std::span<const uint32_t> embedded = find_embedded_shader(path);
+    if (!embedded.empty()) {
+        return ShaderBlob::view(embedded, path);
+    }
+
+    return shader_archive != nullptr ? shader_archive->load(path) : ShaderBlob::map_file(path);
+}
+
+}  // namespace
+
+uint64_t RenderPassLayout::hash() const {
+    Hasher hasher;
+    hasher.add(color_format);
+    hasher.add(samples);
+
+    return hasher.value;
+}
+
+uint64_t GraphicsPipelineDesc::hash() const {
+    Hasher hasher;
+    hasher.add(vert_shader_path);
+    hasher.add(frag_shader_path);
+
+    hasher.add(vertex_bindings.size());
+    for (const VkVertexInputBindingDescription& binding : vertex_bindings) {
+        hasher.add(binding.binding);
+        hasher.add(binding.stride);
+        hasher.add(binding.inputRate);
+    }
+
+    hasher.add(vertex_attributes.size());
+    for (const VkVertexInputAttributeDescription& attribute : vertex_attributes) {
+        hasher.add(attribute.location);
+        hasher.add(attribute.binding);
+        hasher.add(attribute.format);
+        hasher.add(attribute.offset);
+    }
+
+    hash_layout(hasher, set_layouts, push_constant_ranges);
+
+    hasher.add(topology);
+    hasher.add(polygon_mode);
+    hasher.add(cull_mode);
+    hasher.add(front_face);
+    hasher.add(blend_enable);
+
+    return hasher.value;
+}
+
+uint64_t GraphicsPipelineDesc::layout_hash() const {
+    Hasher hasher;
+    hash_layout(hasher, set_layouts, push_constant_ranges);
+
+    return hasher.value;
+}
+
+VkRenderPass create_render_pass(VkDevice device, VkFormat format, VkImageLayout final_layout) {
+    VkAttachmentDescription color_attachment_description = {};
+    color_attachment_description.format                  = format;
+    color_attachment_description.samples                 = VK_SAMPLE_COUNT_1_BIT;
+    color_attachment_description.loadOp                  = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color_attachment_description.storeOp                 = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment_description.stencilLoadOp           = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment_description.stencilStoreOp          = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    color_attachment_description.initialLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+    color_attachment_description.finalLayout             = final_layout;
+
+    VkAttachmentReference color_attachment_reference = {};
+    color_attachment_reference.attachment            = 0;
+    color_attachment_reference.layout                = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass = {};
+    subpass.pipelineBindPoint    = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments    = &color_attachment_reference;
+
+    // Keep the layout transition from starting before the acquired image is actually available.
+    VkSubpassDependency subpass_dependency{};
+    subpass_dependency.srcSubpass    = VK_SUBPASS_EXTERNAL;
+    subpass_dependency.dstSubpass    = 0;
+    subpass_dependency.srcStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    subpass_dependency.srcAccessMask = 0;
+    subpass_dependency.dstStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    subpass_dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+    VkRenderPassCreateInfo render_pass_create_info = {};
+    render_pass_create_info.sType                  = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    render_pass_create_info.attachmentCount        = 1;
+    render_pass_create_info.pAttachments           = &color_attachment_description;
+    render_pass_create_info.subpassCount           = 1;
+    render_pass_create_info.pSubpasses             = &subpass;
+    render_pass_create_info.dependencyCount        = 1;
+    render_pass_create_info.pDependencies          = &subpass_dependency;
+
+    VkRenderPass render_pass = VK_NULL_HANDLE;
+    if (vkCreateRenderPass(device, &render_pass_create_info, nullptr, &render_pass) != VK_SUCCESS) {
+        throw std::runtime_error("create_render_pass => Failed to create render pass!");
+    }
+
+    return render_pass;
+}
+
+VkPipelineLayout create_pipeline_layout(VkDevice device, const std::vector<VkDescriptorSetLayout>& set_layouts,
+                                        const std::vector<VkPushConstantRange>& push_constant_ranges) {
+    VkPipelineLayoutCreateInfo pipeline_layout_info{};
+    pipeline_layout_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeline_layout_info.setLayoutCount         = static_cast<uint32_t>(set_layouts.size());
+    pipeline_layout_info.pSetLayouts            = set_layouts.data();
+    pipeline_layout_info.pushConstantRangeCount = static_cast<uint32_t>(push_constant_ranges.size());
+    pipeline_layout_info.pPushConstantRanges    = push_constant_ranges.data();
+
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    if (vkCreatePipelineLayout(device, &pipeline_layout_info, nullptr, &layout) != VK_SUCCESS) {
+        throw std::runtime_error("create_pipeline_layout => failed to create pipeline layout!");
+    }
+
+    return layout;
+}
+
+GraphicsPipeline create_graphics_pipeline(VkDevice device, VkRenderPass render_pass, const GraphicsPipelineDesc& desc,
+                                          VkPipelineCache pipeline_cache, const ShaderArchive* shader_archive) {
+    GraphicsPipeline graphics_pipeline{};
+    graphics_pipeline.layout = create_pipeline_layout(device, desc.set_layouts, desc.push_constant_ranges);
+
+    try {
+        graphics_pipeline.pipeline = create_graphics_pipeline(device, render_pass, RenderPassLayout{}, desc,
+                                                              graphics_pipeline.layout, pipeline_cache,
+                                                              shader_archive);
+    } catch (...) {
+        vkDestroyPipelineLayout(device, graphics_pipeline.layout, nullptr);
+        throw;
+    }
+
+    return graphics_pipeline;
+}
+
+VkPipeline create_graphics_pipeline(VkDevice device, VkRenderPass render_pass,
+                                    const RenderPassLayout& render_pass_layout, const GraphicsPipelineDesc& desc,
+                                    VkPipelineLayout layout, VkPipelineCache pipeline_cache,
+                                    const ShaderArchive* shader_archive) {
+    ShaderBlob vert_shader_code = load_shader(desc.vert_shader_path, shader_archive);
+    ShaderBlob frag_shader_code = load_shader(desc.frag_shader_path, shader_archive);
+
+    VkShaderModule vert_shader_module = create_shader_module(device, vert_shader_code.code());
+    VkShaderModule frag_shader_module = create_shader_module(device, frag_shader_code.code());
+
+    VkPipelineShaderStageCreateInfo vert_shader_stage_info{};
+    vert_shader_stage_info.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    vert_shader_stage_info.stage  = VK_SHADER_STAGE_VERTEX_BIT;
+    vert_shader_stage_info.module = vert_shader_module;
+    vert_shader_stage_info.pName  = "main";
+
+    VkPipelineShaderStageCreateInfo frag_shader_stage_info{};
+    frag_shader_stage_info.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    frag_shader_stage_info.stage  = VK_SHADER_STAGE_FRAGMENT_BIT;
+    frag_shader_stage_info.module = frag_shader_module;
+    frag_shader_stage_info.pName  = "main";
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages = {vert_shader_stage_info, frag_shader_stage_info};
+
+    VkPipelineVertexInputStateCreateInfo vertex_input_info{};
+    vertex_input_info.sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertex_input_info.vertexBindingDescriptionCount   = static_cast<uint32_t>(desc.vertex_bindings.size());
+    vertex_input_info.pVertexBindingDescriptions      = desc.vertex_bindings.data();
+    vertex_input_info.vertexAttributeDescriptionCount = static_cast<uint32_t>(desc.vertex_attributes.size());
+    vertex_input_info.pVertexAttributeDescriptions    = desc.vertex_attributes.data();
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly_info{};
+    input_assembly_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    input_assembly_info.topology               = desc.topology;
+    input_assembly_info.primitiveRestartEnable = VK_FALSE;
+
+    std::vector<VkDynamicState> dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+
+    VkPipelineDynamicStateCreateInfo dynamic_state_info{};
+    dynamic_state_info.sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamic_state_info.dynamicStateCount = static_cast<uint32_t>(dynamic_states.size());
+    dynamic_state_info.pDynamicStates    = dynamic_states.data();
+
+    // Viewport and scissor are dynamic, only their counts are baked into the pipeline.
+    VkPipelineViewportStateCreateInfo viewport_state_info{};
+    viewport_state_info.sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewport_state_info.viewportCount = 1;
+    viewport_state_info.scissorCount  = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterization_state_info{};
+    rasterization_state_info.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterization_state_info.depthClampEnable        = VK_FALSE;
+    rasterization_state_info.rasterizerDiscardEnable = VK_FALSE;
+    rasterization_state_info.polygonMode             = desc.polygon_mode;
+    rasterization_state_info.lineWidth               = 1.0f;
+    rasterization_state_info.cullMode                = desc.cull_mode;
+    rasterization_state_info.frontFace               = desc.front_face;
+    rasterization_state_info.depthBiasEnable         = VK_FALSE;
+
+    // Optional
+    rasterization_state_info.depthBiasConstantFactor = 0.0f;
+    rasterization_state_info.depthBiasClamp          = 0.0f;
+    rasterization_state_info.depthBiasSlopeFactor    = 0.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisample_state_info{};
+    multisample_state_info.sType                 = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisample_state_info.rasterizationSamples  = render_pass_layout.samples;
+    multisample_state_info.sampleShadingEnable   = VK_FALSE;
+    multisample_state_info.minSampleShading      = 1.0f;
+    multisample_state_info.pSampleMask           = nullptr;
+    multisample_state_info.alphaToCoverageEnable = VK_FALSE;
+    multisample_state_info.alphaToOneEnable      = VK_FALSE;
+
+    VkPipelineColorBlendAttachmentState color_blend_attachment_state{};
+    color_blend_attachment_state.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    // The factors only apply with blend_enable.
+    color_blend_attachment_state.blendEnable         = desc.blend_enable ? VK_TRUE : VK_FALSE;
+    color_blend_attachment_state.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    color_blend_attachment_state.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    color_blend_attachment_state.colorBlendOp        = VK_BLEND_OP_ADD;
+    color_blend_attachment_state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    color_blend_attachment_state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    color_blend_attachment_state.alphaBlendOp        = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo color_blend_state{};
+    color_blend_state.sType           = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    color_blend_state.logicOpEnable   = VK_FALSE;
+    color_blend_state.logicOp         = VK_LOGIC_OP_COPY;  // Optional logic operation
+    color_blend_state.attachmentCount = 1;
+    color_blend_state.pAttachments    = &color_blend_attachment_state;
+
+    // Optional blend constants
+    color_blend_state.blendConstants[0] = 0.0f;
+    color_blend_state.blendConstants[1] = 0.0f;
+    color_blend_state.blendConstants[2] = 0.0f;
+    color_blend_state.blendConstants[3] = 0.0f;
+
+    VkGraphicsPipelineCreateInfo pipeline_create_info{};
+    pipeline_create_info.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipeline_create_info.stageCount          = static_cast<uint32_t>(shader_stages.size());
+    pipeline_create_info.pStages             = shader_stages.data();
+    pipeline_create_info.pVertexInputState   = &vertex_input_info;
+    pipeline_create_info.pInputAssemblyState = &input_assembly_info;
+    pipeline_create_info.pViewportState      = &viewport_state_info;
+    pipeline_create_info.pRasterizationState = &rasterization_state_info;
+    pipeline_create_info.pMultisampleState   = &multisample_state_info;
+    pipeline_create_info.pDepthStencilState  = nullptr;  // Optional;
+    pipeline_create_info.pColorBlendState    = &color_blend_state;
+    pipeline_create_info.pDynamicState       = &dynamic_state_info;
+
+    pipeline_create_info.layout     = layout;
+    pipeline_create_info.renderPass = render_pass;
+    pipeline_create_info.subpass    = 0;
+
+    VkPipelineRenderingCreateInfoKHR rendering_create_info{};
+    rendering_create_info.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    rendering_create_info.colorAttachmentCount    = 1;
+    rendering_create_info.pColorAttachmentFormats = &render_pass_layout.color_format;
+
+    if (render_pass == VK_NULL_HANDLE) {
+        pipeline_create_info.pNext = &rendering_create_info;
+    }
+
+    // Optional
+    pipeline_create_info.basePipelineHandle = VK_NULL_HANDLE;
+    pipeline_create_info.basePipelineIndex  = -1;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkResult   result =
+        vkCreateGraphicsPipelines(device, pipeline_cache, 1, &pipeline_create_info, nullptr, &pipeline);
+
+    vkDestroyShaderModule(device, vert_shader_module, nullptr);
+    vkDestroyShaderModule(device, frag_shader_module, nullptr);
+
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error(
+            "create_graphics_pipeline => failed to create graphics "
+            "pipeline!");
+    }
+
+    return pipeline;
+}
+
+void destroy_graphics_pipeline(VkDevice device, GraphicsPipeline& pipeline) {
+    vkDestroyPipeline(device, pipeline.pipeline, nullptr);
+    vkDestroyPipelineLayout(device, pipeline.layout, nullptr);
+
+    pipeline = {};
+}
+
+ComputePipeline create_compute_pipeline(VkDevice device, const ComputePipelineDesc& desc,
+                                        VkPipelineCache pipeline_cache, const ShaderArchive* shader_archive) {
+    ShaderBlob     shader_code   = load_shader(desc.shader_path, shader_archive);
+    VkShaderModule shader_module = create_shader_module(device, shader_code.code());
+
+    VkPipelineLayoutCreateInfo pipeline_layout_info{};
+    pipeline_layout_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeline_layout_info.setLayoutCount         = static_cast<uint32_t>(desc.set_layouts.size());
+    pipeline_layout_info.pSetLayouts            = desc.set_layouts.data();
+    pipeline_layout_info.pushConstantRangeCount = static_cast<uint32_t>(desc.push_constant_ranges.size());
+    pipeline_layout_info.pPushConstantRanges    = desc.push_constant_ranges.data();
+
+    ComputePipeline compute_pipeline{};
+
+    if (vkCreatePipelineLayout(device, &pipeline_layout_info, nullptr, &compute_pipeline.layout) != VK_SUCCESS) {
+        vkDestroyShaderModule(device, shader_module, nullptr);
+        throw std::runtime_error("create_compute_pipeline => failed to create pipeline layout!");
+    }
+
+    VkComputePipelineCreateInfo pipeline_create_info{};
+    pipeline_create_info.sType        = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipeline_create_info.stage.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipeline_create_info.stage.stage  = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipeline_create_info.stage.module = shader_module;
+    pipeline_create_info.stage.pName  = "main";
+    pipeline_create_info.layout       = compute_pipeline.layout;
+
+    VkResult result = vkCreateComputePipelines(device, pipeline_cache, 1, &pipeline_create_info, nullptr,
+                                               &compute_pipeline.pipeline);
+    vkDestroyShaderModule(device, shader_module, nullptr);
+
+    if (result != VK_SUCCESS) {
+        vkDestroyPipelineLayout(device, compute_pipeline.layout, nullptr);
+        throw std::runtime_error("create_compute_pipeline => failed to create compute pipeline!");
+    }
+
+    return compute_pipeline;
+}
+
+void destroy_compute_pipeline(VkDevice device, ComputePipeline& pipeline) {
+    vkDestroyPipeline(device, pipeline.pipeline, nullptr);
+    vkDestroyPipelineLayout(device, pipeline.layout, nullptr);
+
+    pipeline = {};
+}
+
+}  // namespace renderer
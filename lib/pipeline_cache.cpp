@@ -0,0 +1,159 @@
+#include "pipeline_cache.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace renderer {
+
+namespace {
+
+// FNV-1a, only used to detect truncated or corrupt cache files.
+uint64_t hash_bytes(const std::byte* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint64_t>(data[i]);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+}  // namespace
+
+void PipelineCache::init(const DeviceContext& context, const std::string& directory, const std::string& name) {
+    m_context = &context;
+
+    VkPhysicalDeviceProperties device_properties;
+    vkGetPhysicalDeviceProperties(context.physical_device(), &device_properties);
+
+    m_expected.vendor_id      = device_properties.vendorID;
+    m_expected.device_id      = device_properties.deviceID;
+    m_expected.driver_version = device_properties.driverVersion;
+    std::memcpy(m_expected.cache_uuid, device_properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+    std::ostringstream path;
+    path << directory << "/" << name << std::hex << std::setfill('0') << "-" << std::setw(4) << m_expected.vendor_id
+         << "-" << std::setw(4) << m_expected.device_id << "-" << std::setw(8) << m_expected.driver_version
+         << ".pcache";
+    m_path = path.str();
+
+    std::vector<std::byte> initial_data = load_file();
+    m_loaded_size                       = initial_data.size();
+
+    VkPipelineCacheCreateInfo pipeline_cache_create_info{};
+    pipeline_cache_create_info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipeline_cache_create_info.initialDataSize = initial_data.size();
+    pipeline_cache_create_info.pInitialData    = initial_data.empty() ? nullptr : initial_data.data();
+
+    if (vkCreatePipelineCache(context.device(), &pipeline_cache_create_info, nullptr, &m_cache) != VK_SUCCESS) {
+        throw std::runtime_error("PipelineCache::init => failed to create pipeline cache!");
+    }
+}
+
+void PipelineCache::cleanup() {
+    VkDevice device = m_context->device();
+
+    size_t data_size = 0;
+    if (vkGetPipelineCacheData(device, m_cache, &data_size, nullptr) == VK_SUCCESS && data_size > 0) {
+        std::vector<std::byte> data(data_size);
+
+        if (vkGetPipelineCacheData(device, m_cache, &data_size, data.data()) == VK_SUCCESS) {
+            data.resize(data_size);
+            save_file(data);
+        }
+    }
+
+    vkDestroyPipelineCache(device, m_cache, nullptr);
+
+    m_cache       = VK_NULL_HANDLE;
+    m_loaded_size = 0;
+}
+
+std::vector<std::byte> PipelineCache::load_file() const {
+    std::ifstream file(m_path, std::ios::binary);
+    if (!file.is_open()) {
+        return {};
+    }
+
+    FileHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return {};
+    }
+
+    // Refuse absurd sizes before allocating, the header may be garbage.
+    std::error_code error;
+    if (header.data_size > std::filesystem::file_size(m_path, error) || error) {
+        return {};
+    }
+
+    std::vector<std::byte> data(static_cast<size_t>(header.data_size));
+    if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())) ||
+        !validate(header, data)) {
+        std::cerr << "PipelineCache: ignoring stale or corrupt cache " << m_path << "\n";
+        return {};
+    }
+
+    return data;
+}
+
+void PipelineCache::save_file(const std::vector<std::byte>& data) const {
+    std::filesystem::path path      = m_path;
+    std::filesystem::path temp_path = m_path + ".tmp";
+
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    FileHeader header = m_expected;
+    header.data_size  = data.size();
+    header.data_hash  = hash_bytes(data.data(), data.size());
+
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+        if (!file.good()) {
+            std::cerr << "PipelineCache: failed to write " << temp_path << "\n";
+            std::filesystem::remove(temp_path, error);
+            return;
+        }
+    }
+
+    // rename() replaces the old file atomically, readers see either the old or the new cache.
+    std::filesystem::rename(temp_path, path, error);
+    if (error) {
+        std::cerr << "PipelineCache: failed to replace " << m_path << ": " << error.message() << "\n";
+        std::filesystem::remove(temp_path, error);
+    }
+}
+
+bool PipelineCache::validate(const FileHeader& header, const std::vector<std::byte>& data) const {
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION || header.vendor_id != m_expected.vendor_id ||
+        header.device_id != m_expected.device_id || header.driver_version != m_expected.driver_version ||
+        std::memcmp(header.cache_uuid, m_expected.cache_uuid, VK_UUID_SIZE) != 0) {
+        return false;
+    }
+
+    if (hash_bytes(data.data(), data.size()) != header.data_hash) {
+        return false;
+    }
+
+    // The driver blob starts with VkPipelineCacheHeaderVersionOne, check it agrees with our header.
+    VkPipelineCacheHeaderVersionOne driver_header{};
+    if (data.size() < sizeof(driver_header)) {
+        return false;
+    }
+    std::memcpy(&driver_header, data.data(), sizeof(driver_header));
+
+    return driver_header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           driver_header.vendorID == m_expected.vendor_id && driver_header.deviceID == m_expected.device_id &&
+           std::memcmp(driver_header.pipelineCacheUUID, m_expected.cache_uuid, VK_UUID_SIZE) == 0;
+}
+
+}  // namespace renderer
@@ -0,0 +1,111 @@
+#include "pipeline_compiler.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <utility>
+
+namespace renderer {
+
+void PipelineCompiler::init(PipelineStateCache& pipeline_states, uint32_t thread_count) {
+    m_pipeline_states = &pipeline_states;
+    m_stopping        = false;
+    m_stats           = {};
+
+    for (uint32_t i = 0; i < std::max(thread_count, 1u); ++i) {
+        m_threads.emplace_back(&PipelineCompiler::worker_main, this);
+    }
+}
+
+void PipelineCompiler::cleanup() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+
+    m_threads.clear();
+    m_pending.clear();
+    m_failed.clear();
+}
+
+uint64_t PipelineCompiler::request(const GraphicsPipelineDesc& desc, const RenderPassLayout& render_pass_layout) {
+    const uint64_t key = m_pipeline_states->key(desc, render_pass_layout);
+
+    {
+        // Workers publish before they leave m_pending, so a key that is not pending is either new or published.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pending.contains(key) || m_failed.contains(key) || find(key).pipeline != VK_NULL_HANDLE) {
+            return key;
+        }
+
+        m_pending.insert(key);
+        m_queue.push_back({key, desc, render_pass_layout, std::chrono::steady_clock::now()});
+        m_stats.requested++;
+    }
+    m_wake.notify_one();
+
+    return key;
+}
+
+void PipelineCompiler::wait_idle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_queue.empty() && m_active == 0; });
+}
+
+PipelineCompilerStats PipelineCompiler::stats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void PipelineCompiler::worker_main() {
+    while (true) {
+        Request request{};
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_stopping) {
+                return;
+            }
+
+            request = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_active++;
+        }
+
+        // create() rather than get(): this thread is not synchronized with the render thread's reclaim().
+        bool compiled = true;
+        try {
+            m_pipeline_states->create(request.desc, request.render_pass_layout);
+        } catch (const std::exception& e) {
+            std::cerr << "PipelineCompiler::worker_main => " << e.what() << "\n";
+            compiled = false;
+        }
+
+        auto   compiled_time = std::chrono::steady_clock::now();
+        double latency_ms    = std::chrono::duration<double, std::milli>(compiled_time - request.requested).count();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending.erase(request.key);
+            m_active--;
+
+            if (compiled) {
+                m_stats.compiled++;
+                m_stats.total_latency_ms += latency_ms;
+                m_stats.max_latency_ms = std::max(m_stats.max_latency_ms, latency_ms);
+            } else {
+                m_failed.insert(request.key);
+                m_stats.failed++;
+            }
+        }
+        m_idle.notify_all();
+    }
+}
+
+}  // namespace renderer
@@ -0,0 +1,251 @@
+#include "pipeline_state_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+namespace renderer {
+
+void PipelineStateCache::init(const DeviceContext& context, VkPipelineCache pipeline_cache,
+                              const ShaderArchive* shader_archive) {
+    m_context        = &context;
+    m_pipeline_cache = pipeline_cache;
+    m_shader_archive = shader_archive;
+    m_stats          = {};
+    m_hits.store(0, std::memory_order_relaxed);
+
+    m_maps.push_back(std::make_unique<const PipelineMap>());
+    m_pipelines.store(m_maps.back().get(), std::memory_order_release);
+}
+
+void PipelineStateCache::cleanup() {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+
+    VkDevice device = m_context->device();
+
+    for (const auto& [key, pipeline] : *m_pipelines.load(std::memory_order_acquire)) {
+        vkDestroyPipeline(device, pipeline.pipeline, nullptr);
+    }
+    for (const RetiredPipeline& retired : m_retired) {
+        vkDestroyPipeline(device, retired.pipeline, nullptr);
+    }
+    for (const auto& [key, layout] : m_layouts) {
+        vkDestroyPipelineLayout(device, layout, nullptr);
+    }
+
+    m_pipelines.store(nullptr, std::memory_order_release);
+    m_maps.clear();
+    m_layouts.clear();
+    m_render_passes.clear();
+    m_descriptions.clear();
+    m_retired.clear();
+}
+
+void PipelineStateCache::add_render_pass(const RenderPassLayout& render_pass_layout, VkRenderPass render_pass) {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    m_render_passes.try_emplace(render_pass_layout.hash(), render_pass);
+}
+
+uint64_t PipelineStateCache::key(const GraphicsPipelineDesc& desc, const RenderPassLayout& render_pass_layout) const {
+    uint64_t key     = desc.hash();
+    auto     combine = [&key](uint64_t value) {
+        // boost::hash_combine, widened to 64 bits.
+        key ^= value + 0x9e3779b97f4a7c15ull + (key << 6) + (key >> 2);
+    };
+
+    combine(render_pass_layout.hash());
+    if (m_shader_archive != nullptr) {
+        combine(m_shader_archive->content_hash(desc.vert_shader_path));
+        combine(m_shader_archive->content_hash(desc.frag_shader_path));
+    }
+
+    return key;
+}
+
+GraphicsPipeline PipelineStateCache::find(uint64_t key) const {
+    const PipelineMap& pipelines = *m_pipelines.load(std::memory_order_acquire);
+
+    auto it = pipelines.find(key);
+    return it != pipelines.end() ? it->second : GraphicsPipeline{};
+}
+
+GraphicsPipeline PipelineStateCache::get(const GraphicsPipelineDesc& desc, const RenderPassLayout& render_pass_layout) {
+    const uint64_t pipeline_key = key(desc, render_pass_layout);
+
+    GraphicsPipeline pipeline = find(pipeline_key);
+    if (pipeline.pipeline != VK_NULL_HANDLE) {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return pipeline;
+    }
+
+    return create(desc, render_pass_layout);
+}
+
+GraphicsPipeline PipelineStateCache::create(const GraphicsPipelineDesc& desc,
+                                            const RenderPassLayout& render_pass_layout) {
+    const uint64_t pipeline_key = key(desc, render_pass_layout);
+
+    GraphicsPipeline pipeline{};
+    VkRenderPass     render_pass{};
+    {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        pipeline.layout = get_layout(desc);
+        render_pass     = get_render_pass(render_pass_layout);
+    }
+
+    auto create_start = std::chrono::steady_clock::now();
+    pipeline.pipeline =
+        create_graphics_pipeline(m_context->device(), render_pass, render_pass_layout, desc, pipeline.layout,
+                                 m_pipeline_cache, m_shader_archive);
+    auto create_end = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    m_stats.create_ms += std::chrono::duration<double, std::milli>(create_end - create_start).count();
+    m_descriptions.try_emplace(pipeline_key, Description{desc, render_pass_layout});
+
+    return publish(pipeline_key, pipeline);
+}
+
+std::vector<PipelineRebuild> PipelineStateCache::rebuild(std::string_view shader_path, uint64_t retire_value) {
+    const std::string_view name = shader_name(shader_path);
+
+    std::vector<std::pair<uint64_t, Description>> affected;
+    {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        for (const auto& [key, description] : m_descriptions) {
+            if (shader_name(description.desc.vert_shader_path) == name ||
+                shader_name(description.desc.frag_shader_path) == name) {
+                affected.emplace_back(key, description);
+            }
+        }
+    }
+
+    std::vector<PipelineRebuild>                 rebuilds;
+    std::vector<std::pair<uint64_t, VkPipeline>> replacements;
+
+    for (const auto& [key, description] : affected) {
+        PipelineRebuild& rebuild = rebuilds.emplace_back();
+        rebuild.key              = key;
+        rebuild.vert_shader_path = description.desc.vert_shader_path;
+        rebuild.frag_shader_path = description.desc.frag_shader_path;
+
+        VkRenderPass render_pass{};
+        {
+            std::lock_guard<std::mutex> lock(m_write_mutex);
+            render_pass = get_render_pass(description.render_pass_layout);
+        }
+
+        // The layout only depends on set layouts and push constants, which a shader edit cannot change.
+        auto rebuild_start = std::chrono::steady_clock::now();
+        try {
+            VkPipeline pipeline =
+                create_graphics_pipeline(m_context->device(), render_pass, description.render_pass_layout,
+                                         description.desc, find(key).layout, m_pipeline_cache, m_shader_archive);
+            replacements.emplace_back(key, pipeline);
+            rebuild.rebuilt = true;
+        } catch (const std::exception& e) {
+            std::cerr << "PipelineStateCache::rebuild => " << e.what() << "\n";
+        }
+        auto rebuild_end = std::chrono::steady_clock::now();
+
+        rebuild.rebuild_ms = std::chrono::duration<double, std::milli>(rebuild_end - rebuild_start).count();
+    }
+
+    if (replacements.empty()) {
+        return rebuilds;
+    }
+
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+
+    auto next = std::make_unique<PipelineMap>(*m_pipelines.load(std::memory_order_acquire));
+    for (const auto& [key, pipeline] : replacements) {
+        VkPipeline& published = (*next)[key].pipeline;
+        m_retired.push_back({published, retire_value});
+        published = pipeline;
+    }
+
+    m_maps.push_back(std::move(next));
+    m_pipelines.store(m_maps.back().get(), std::memory_order_release);
+
+    for (const PipelineRebuild& rebuild : rebuilds) {
+        if (rebuild.rebuilt) {
+            m_stats.pipelines_rebuilt++;
+            m_stats.rebuild_ms += rebuild.rebuild_ms;
+            m_stats.max_rebuild_ms = std::max(m_stats.max_rebuild_ms, rebuild.rebuild_ms);
+        }
+    }
+
+    return rebuilds;
+}
+
+void PipelineStateCache::reclaim(FrameScheduler& frame_scheduler) {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+
+    // The published map is always the newest one.
+    if (m_maps.size() > 1) {
+        m_maps.erase(m_maps.begin(), m_maps.end() - 1);
+    }
+
+    while (!m_retired.empty() && frame_scheduler.is_complete(m_retired.front().retire_value)) {
+        vkDestroyPipeline(m_context->device(), m_retired.front().pipeline, nullptr);
+        m_retired.pop_front();
+    }
+}
+
+PipelineStateStats PipelineStateCache::stats() {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+
+    PipelineStateStats stats = m_stats;
+    stats.deduplicated += m_hits.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+VkPipelineLayout PipelineStateCache::get_layout(const GraphicsPipelineDesc& desc) {
+    const uint64_t layout_key = desc.layout_hash();
+
+    auto it = m_layouts.find(layout_key);
+    if (it != m_layouts.end()) {
+        return it->second;
+    }
+
+    VkPipelineLayout layout = create_pipeline_layout(m_context->device(), desc.set_layouts, desc.push_constant_ranges);
+    m_layouts.emplace(layout_key, layout);
+    m_stats.layouts_created++;
+
+    return layout;
+}
+
+VkRenderPass PipelineStateCache::get_render_pass(const RenderPassLayout& render_pass_layout) {
+    auto it = m_render_passes.find(render_pass_layout.hash());
+    if (it == m_render_passes.end()) {
+        throw std::runtime_error("PipelineStateCache::get_render_pass => no render pass registered for this layout!");
+    }
+
+    return it->second;
+}
+
+// Called with m_write_mutex held.
+GraphicsPipeline PipelineStateCache::publish(uint64_t key, const GraphicsPipeline& pipeline) {
+    const PipelineMap& current = *m_pipelines.load(std::memory_order_acquire);
+
+    // Another thread created the same pipeline in the meantime; keep the published one.
+    auto it = current.find(key);
+    if (it != current.end()) {
+        vkDestroyPipeline(m_context->device(), pipeline.pipeline, nullptr);
+        m_stats.deduplicated++;
+        return it->second;
+    }
+
+    auto next = std::make_unique<PipelineMap>(current);
+    next->emplace(key, pipeline);
+
+    m_maps.push_back(std::move(next));
+    m_pipelines.store(m_maps.back().get(), std::memory_order_release);
+    m_stats.pipelines_created++;
+
+    return pipeline;
+}
+
+}  // namespace renderer
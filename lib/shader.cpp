@@ -0,0 +1,133 @@
+#include "shader.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace renderer {
+
+/* ---- MappedFile ---- */
+
+MappedFile::~MappedFile() {
+    reset();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        reset();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+
+    return *this;
+}
+
+MappedFile MappedFile::map(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("MappedFile::map => failed to open file: " + path);
+    }
+
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw std::runtime_error("MappedFile::map => failed to stat file: " + path);
+    }
+
+    const size_t size = static_cast<size_t>(file_stat.st_size);
+    if (size == 0) {
+        close(fd);
+        throw std::runtime_error("MappedFile::map => empty file: " + path);
+    }
+
+    // The mapping keeps the file referenced, the descriptor is not needed past mmap(). MAP_POPULATE faults every page
+    // in with this call instead of one fault per page on first touch.
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("MappedFile::map => failed to map file: " + path);
+    }
+
+    MappedFile file{};
+    file.m_data = data;
+    file.m_size = size;
+
+    return file;
+}
+
+void MappedFile::reset() {
+    if (m_data != nullptr) {
+        munmap(m_data, m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+/* ---- ShaderBlob ---- */
+
+ShaderBlob ShaderBlob::map_file(const std::string& path) {
+    ShaderBlob blob{};
+    blob.m_file = MappedFile::map(path);
+
+    std::span<const std::byte> bytes = blob.m_file.bytes();
+    validate_spirv(bytes, path);
+    blob.m_code = {reinterpret_cast<const uint32_t*>(bytes.data()), bytes.size() / sizeof(uint32_t)};
+
+    return blob;
+}
+
+ShaderBlob ShaderBlob::view(std::span<const uint32_t> code, const std::string& name) {
+    validate_spirv(std::as_bytes(code), name);
+
+    ShaderBlob blob{};
+    blob.m_code = code;
+
+    return blob;
+}
+
+/* ---- Shader modules ---- */
+
+void validate_spirv(std::span<const std::byte> code, const std::string& name) {
+    if (reinterpret_cast<uintptr_t>(code.data()) % alignof(uint32_t) != 0) {
+        throw std::runtime_error("validate_spirv => code is not 4-byte aligned: " + name);
+    }
+    if (code.size() % sizeof(uint32_t) != 0) {
+        throw std::runtime_error("validate_spirv => size is not a whole number of words: " + name);
+    }
+    if (code.size() < ShaderBlob::SPIRV_HEADER_WORDS * sizeof(uint32_t)) {
+        throw std::runtime_error("validate_spirv => shorter than a SPIR-V header: " + name);
+    }
+
+    // A byte-swapped magic would be valid SPIR-V for another endianness, but Vulkan only accepts the host's.
+    uint32_t magic = 0;
+    std::memcpy(&magic, code.data(), sizeof(magic));
+    if (magic != ShaderBlob::SPIRV_MAGIC) {
+        throw std::runtime_error("validate_spirv => bad SPIR-V magic number: " + name);
+    }
+}
+
+VkShaderModule create_shader_module(VkDevice device, std::span<const uint32_t> code) {
+    VkShaderModuleCreateInfo create_info{};
+    create_info.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    create_info.codeSize = code.size_bytes();
+    create_info.pCode    = code.data();
+
+    VkShaderModule shader_module;
+    if (vkCreateShaderModule(device, &create_info, nullptr, &shader_module) != VK_SUCCESS) {
+        throw std::runtime_error("create_shader_module => failed to create shader module!");
+    }
+
+    return shader_module;
+}
+
+}  // namespace renderer
@@ -0,0 +1,212 @@
+#include "shader_archive.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace renderer {
+
+namespace {
+
+uint64_t hash_bytes(std::span<const std::byte> bytes) {
+    uint64_t hash = 14695981039346656037ull;
+    for (std::byte byte : bytes) {
+        hash ^= static_cast<uint64_t>(byte);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+uint64_t hash_name(std::string_view name) {
+    return hash_bytes(std::as_bytes(std::span<const char>(name.data(), name.size())));
+}
+
+[[noreturn]] void invalid_archive(const std::string& path, const char* reason) {
+    throw std::runtime_error("ShaderArchive::init => " + path + ": " + reason + "!");
+}
+
+size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+std::string_view shader_name(std::string_view path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+bool ShaderArchive::init(const std::string& path) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return false;
+    }
+
+    m_path = path;
+    m_file = MappedFile::map(path);
+
+    std::span<const std::byte> bytes = m_file.bytes();
+
+    // The mapping is page aligned, so the header and the index can be used in place.
+    if (bytes.size() < sizeof(ShaderArchiveHeader)) {
+        invalid_archive(path, "truncated header");
+    }
+
+    const auto& header = *reinterpret_cast<const ShaderArchiveHeader*>(bytes.data());
+    if (header.magic != MAGIC || header.version != VERSION) {
+        invalid_archive(path, "not a shader archive of this version");
+    }
+
+    const size_t index_offset = sizeof(ShaderArchiveHeader);
+    const size_t names_offset = index_offset + size_t{header.entry_count} * sizeof(ShaderArchiveEntry);
+    if (header.entry_count == 0 || names_offset + header.names_size > bytes.size()) {
+        invalid_archive(path, "truncated index");
+    }
+
+    m_entries = {reinterpret_cast<const ShaderArchiveEntry*>(bytes.data() + index_offset), header.entry_count};
+    m_names   = {reinterpret_cast<const char*>(bytes.data() + names_offset), header.names_size};
+
+    // Checked once here so that find() and load() can trust the index.
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const ShaderArchiveEntry& entry = m_entries[i];
+
+        if (entry.name_offset >= m_names.size() || m_names.find('\0', entry.name_offset) == std::string_view::npos) {
+            invalid_archive(path, "name out of bounds");
+        }
+        if (entry.offset % CODE_ALIGNMENT != 0 || entry.offset < names_offset + header.names_size ||
+            entry.offset + entry.size > bytes.size()) {
+            invalid_archive(path, "code out of bounds");
+        }
+        if (i > 0 && m_entries[i - 1].name_hash > entry.name_hash) {
+            invalid_archive(path, "index not sorted");
+        }
+    }
+
+    return true;
+}
+
+void ShaderArchive::cleanup() {
+    m_entries = {};
+    m_names   = {};
+    m_file    = {};
+}
+
+const ShaderArchiveEntry* ShaderArchive::find(std::string_view path) const {
+    const std::string_view name      = shader_name(path);
+    const uint64_t         name_hash = hash_name(name);
+
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), name_hash,
+                               [](const ShaderArchiveEntry& entry, uint64_t hash) { return entry.name_hash < hash; });
+
+    // Names are compared as well, two of them could share a hash.
+    for (; it != m_entries.end() && it->name_hash == name_hash; ++it) {
+        if (this->name(*it) == name) {
+            return &*it;
+        }
+    }
+
+    return nullptr;
+}
+
+ShaderBlob ShaderArchive::load(const std::string& path) const {
+    const ShaderArchiveEntry* entry = find(path);
+    if (entry == nullptr) {
+        return ShaderBlob::map_file(path);
+    }
+
+    const auto* code = reinterpret_cast<const uint32_t*>(m_file.bytes().data() + entry->offset);
+    return ShaderBlob::view({code, entry->size / sizeof(uint32_t)}, m_path + ":" + std::string(name(*entry)));
+}
+
+uint64_t ShaderArchive::content_hash(std::string_view path) const {
+    const ShaderArchiveEntry* entry = find(path);
+    return entry != nullptr ? entry->content_hash : 0;
+}
+
+std::string_view ShaderArchive::name(const ShaderArchiveEntry& entry) const {
+    return m_names.data() + entry.name_offset;
+}
+
+void ShaderArchive::write(const std::string& path, const std::vector<std::string>& inputs) {
+    class Input {
+       public:
+        std::string_view   name;
+        ShaderBlob         blob;
+        ShaderArchiveEntry entry;
+    };
+
+    if (inputs.empty()) {
+        throw std::runtime_error("ShaderArchive::write => no shaders to pack!");
+    }
+
+    std::vector<Input> packed;
+    packed.reserve(inputs.size());
+
+    for (const std::string& input : inputs) {
+        Input& shader = packed.emplace_back(Input{shader_name(input), ShaderBlob::map_file(input), {}});
+        shader.entry.name_hash    = hash_name(shader.name);
+        shader.entry.content_hash = hash_bytes(std::as_bytes(shader.blob.code()));
+        shader.entry.size         = static_cast<uint32_t>(shader.blob.size_bytes());
+    }
+
+    std::sort(packed.begin(), packed.end(), [](const Input& a, const Input& b) {
+        return a.entry.name_hash != b.entry.name_hash ? a.entry.name_hash < b.entry.name_hash : a.name < b.name;
+    });
+
+    for (size_t i = 1; i < packed.size(); ++i) {
+        if (packed[i - 1].name == packed[i].name) {
+            throw std::runtime_error("ShaderArchive::write => duplicate shader name: " + std::string(packed[i].name) +
+                                     "!");
+        }
+    }
+
+    // Lay out names, then code.
+    std::string names;
+    for (Input& shader : packed) {
+        shader.entry.name_offset = static_cast<uint32_t>(names.size());
+        names.append(shader.name);
+        names.push_back('\0');
+    }
+
+    size_t offset = sizeof(ShaderArchiveHeader) + packed.size() * sizeof(ShaderArchiveEntry) + names.size();
+    for (Input& shader : packed) {
+        offset              = align_up(offset, CODE_ALIGNMENT);
+        shader.entry.offset = offset;
+        offset += shader.entry.size;
+    }
+
+    ShaderArchiveHeader header{};
+    header.magic       = MAGIC;
+    header.version     = VERSION;
+    header.entry_count = static_cast<uint32_t>(packed.size());
+    header.names_size  = static_cast<uint32_t>(names.size());
+
+    std::filesystem::path temp_path = path + ".tmp";
+
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const Input& shader : packed) {
+            file.write(reinterpret_cast<const char*>(&shader.entry), sizeof(shader.entry));
+        }
+        file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+        static constexpr char padding[CODE_ALIGNMENT] = {};
+        for (const Input& shader : packed) {
+            file.write(padding, static_cast<std::streamsize>(shader.entry.offset - static_cast<size_t>(file.tellp())));
+            file.write(reinterpret_cast<const char*>(shader.blob.code().data()),
+                       static_cast<std::streamsize>(shader.entry.size));
+        }
+
+        if (!file.good()) {
+            throw std::runtime_error("ShaderArchive::write => failed to write " + temp_path.string() + "!");
+        }
+    }
+
+    // Apps running while the archive is rebuilt keep the old file mapped; rename() never changes it under them.
+    std::filesystem::rename(temp_path, path);
+}
+
+}  // namespace renderer
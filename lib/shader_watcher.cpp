@@ -0,0 +1,159 @@
+#include "shader_watcher.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace renderer {
+
+namespace {
+
+bool is_shader_source(std::string_view name) {
+    return name.ends_with(".vert") || name.ends_with(".frag") || name.ends_with(".comp");
+}
+
+}  // namespace
+
+void ShaderWatcher::init(const std::string& source_directory, const std::string& output_directory,
+                         const std::string& compiler) {
+    m_source_directory = source_directory;
+    m_output_directory = output_directory;
+    m_compiler         = compiler;
+
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_wake    = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_inotify < 0 || m_wake < 0) {
+        cleanup();
+        throw std::runtime_error("ShaderWatcher::init => failed to create inotify or eventfd descriptors!");
+    }
+
+    // Editors save either in place (close after write) or by renaming a temporary file over the source.
+    if (inotify_add_watch(m_inotify, source_directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        cleanup();
+        throw std::runtime_error("ShaderWatcher::init => failed to watch " + source_directory + "!");
+    }
+
+    m_thread = std::thread(&ShaderWatcher::watch_main, this);
+
+    std::cout << "ShaderWatcher::init => recompiling shaders saved in " << source_directory << " into "
+              << output_directory << "\n";
+}
+
+void ShaderWatcher::cleanup() {
+    if (m_thread.joinable()) {
+        const uint64_t one = 1;
+        (void)write(m_wake, &one, sizeof(one));
+        m_thread.join();
+    }
+
+    if (m_inotify >= 0) {
+        close(m_inotify);
+    }
+    if (m_wake >= 0) {
+        close(m_wake);
+    }
+
+    m_inotify = -1;
+    m_wake    = -1;
+    m_changes.clear();
+}
+
+std::vector<ShaderChange> ShaderWatcher::take_changes() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::exchange(m_changes, {});
+}
+
+void ShaderWatcher::watch_main() {
+    std::array<pollfd, 2> fds = {{{m_inotify, POLLIN, 0}, {m_wake, POLLIN, 0}}};
+
+    // Sources saved since the last compile; compiled once no event arrived for SETTLE_MS.
+    std::vector<std::string> saved;
+
+    alignas(inotify_event) std::array<char, 4096> buffer;
+
+    while (true) {
+        int ready = poll(fds.data(), fds.size(), saved.empty() ? -1 : SETTLE_MS);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "ShaderWatcher::watch_main => poll failed, no longer watching shaders\n";
+            return;
+        }
+        if (fds[1].revents & POLLIN) {
+            return;
+        }
+
+        if (ready == 0) {
+            for (const std::string& source_name : saved) {
+                ShaderChange change{};
+                if (compile(source_name, change)) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_changes.push_back(std::move(change));
+                }
+            }
+            saved.clear();
+            continue;
+        }
+
+        ssize_t length = 0;
+        while ((length = read(m_inotify, buffer.data(), buffer.size())) > 0) {
+            for (ssize_t offset = 0; offset < length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                std::string name = event->len > 0 ? event->name : "";
+                if (is_shader_source(name) && std::find(saved.begin(), saved.end(), name) == saved.end()) {
+                    saved.push_back(std::move(name));
+                }
+            }
+        }
+    }
+}
+
+bool ShaderWatcher::compile(const std::string& source_name, ShaderChange& change) const {
+    const std::filesystem::path source    = std::filesystem::path(m_source_directory) / source_name;
+    const std::filesystem::path output    = std::filesystem::path(m_output_directory) / (source_name + ".spv");
+    const std::filesystem::path temp_path = output.string() + ".tmp";
+
+    // The compiler writes next to the output and the result is renamed over it, so a pipeline being created from
+    // the old file never maps a half-written one.
+    const std::string command = m_compiler + " -o '" + temp_path.string() + "' '" + source.string() + "'";
+
+    auto compile_start = std::chrono::steady_clock::now();
+    int  status        = std::system(command.c_str());
+    auto compile_end   = std::chrono::steady_clock::now();
+
+    std::error_code error;
+    if (status != 0) {
+        std::cerr << "ShaderWatcher::compile => " << source.string() << " failed to compile, keeping the old code\n";
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+
+    std::filesystem::rename(temp_path, output, error);
+    if (error) {
+        std::cerr << "ShaderWatcher::compile => failed to replace " << output.string() << ": " << error.message()
+                  << "\n";
+        return false;
+    }
+
+    change.spv_path   = output.string();
+    change.compile_ms = std::chrono::duration<double, std::milli>(compile_end - compile_start).count();
+
+    return true;
+}
+
+}  // namespace renderer
@@ -0,0 +1,281 @@
+#include "swapchain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+namespace renderer {
+
+void Swapchain::init(const DeviceContext& context) {
+    m_context   = &context;
+    m_offscreen = false;
+
+    create_swapchain();
+    create_image_views();
+    create_render_finished_semaphores();
+}
+
+void Swapchain::init_offscreen(const DeviceContext& context, VkExtent2D extent, uint32_t image_count) {
+    m_context   = &context;
+    m_offscreen = true;
+    m_format    = OFFSCREEN_FORMAT;
+    m_extent    = extent;
+
+    create_offscreen_images(image_count);
+    create_image_views();
+}
+
+void Swapchain::cleanup() {
+    VkDevice device = m_context->device();
+
+    for (VkImageView image_view : m_image_views) {
+        vkDestroyImageView(device, image_view, nullptr);
+    }
+    m_image_views.clear();
+
+    // Destroy per-swapchain-image render-finished semaphores.
+    for (VkSemaphore sem : m_semaphores_render_finished) {
+        if (sem != VK_NULL_HANDLE) {
+            vkDestroySemaphore(device, sem, nullptr);
+        }
+    }
+    m_semaphores_render_finished.clear();
+
+    // Offscreen images are owned by us, swapchain images are owned by the swapchain.
+    if (m_offscreen) {
+        for (size_t i = 0; i < m_images.size(); ++i) {
+            vkDestroyImage(device, m_images[i], nullptr);
+            m_context->allocator().free(m_offscreen_image_memory[i]);
+        }
+        m_offscreen_image_memory.clear();
+    } else {
+        vkDestroySwapchainKHR(device, m_swapchain, nullptr);
+        m_swapchain = VK_NULL_HANDLE;
+    }
+
+    m_images.clear();
+}
+
+void Swapchain::recreate() {
+    int width = 0, height = 0;
+    glfwGetFramebufferSize(m_context->window(), &width, &height);
+    while (width == 0 || height == 0) {
+        glfwGetFramebufferSize(m_context->window(), &width, &height);
+        glfwWaitEvents();
+    }
+
+    vkDeviceWaitIdle(m_context->device());
+
+    cleanup();
+    init(*m_context);
+}
+
+VkResult Swapchain::acquire_next_image(VkSemaphore image_available_semaphore, uint32_t* image_index) {
+    if (m_offscreen) {
+        *image_index           = m_next_offscreen_image;
+        m_next_offscreen_image = (m_next_offscreen_image + 1) % image_count();
+        return VK_SUCCESS;
+    }
+
+    return vkAcquireNextImageKHR(m_context->device(), m_swapchain, UINT64_MAX, image_available_semaphore,
+                                 VK_NULL_HANDLE, image_index);
+}
+
+VkResult Swapchain::present(VkQueue present_queue, uint32_t image_index) {
+    if (m_offscreen) {
+        return VK_SUCCESS;
+    }
+
+    std::array<VkSwapchainKHR, 1> swapchains                = {m_swapchain};
+    VkSemaphore                   render_finished_semaphore = m_semaphores_render_finished[image_index];
+
+    VkPresentInfoKHR present_info{};
+    present_info.sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    present_info.waitSemaphoreCount = 1;
+    present_info.pWaitSemaphores    = &render_finished_semaphore;
+    present_info.swapchainCount     = static_cast<uint32_t>(swapchains.size());
+    present_info.pSwapchains        = swapchains.data();
+    present_info.pImageIndices      = &image_index;
+    present_info.pResults           = nullptr;  // Optional
+
+    return vkQueuePresentKHR(present_queue, &present_info);
+}
+
+VkImageLayout Swapchain::final_layout() const {
+    return m_offscreen ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
+void Swapchain::create_swapchain() {
+    SwapChainSupportDetails support_details = m_context->query_swapchain_support_details();
+
+    VkSurfaceFormatKHR surface_format = choose_swapchain_surface_format(support_details.formats);
+    VkPresentModeKHR   present_mode   = choose_swapchain_present_mode(support_details.present_modes);
+    VkExtent2D         extent         = choose_swapchain_extent(support_details.capabilities);
+
+    uint32_t image_count = support_details.capabilities.minImageCount + 1;
+
+    if (support_details.capabilities.maxImageCount > 0 && image_count > support_details.capabilities.maxImageCount) {
+        image_count = support_details.capabilities.maxImageCount;
+    }
+
+    VkSwapchainCreateInfoKHR create_info = {};
+    create_info.sType                    = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+    create_info.surface                  = m_context->surface();
+    create_info.minImageCount            = image_count;
+    create_info.imageFormat              = surface_format.format;
+    create_info.imageColorSpace          = surface_format.colorSpace;
+    create_info.imageExtent              = extent;
+    create_info.imageArrayLayers         = 1;
+    create_info.imageUsage               = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+    const QueueFamilyIndices& queue_family_indices         = m_context->queue_family_indices();
+    uint32_t                  queue_family_indices_array[] = {queue_family_indices.graphics_family.value(),
+                                                              queue_family_indices.present_family.value()};
+
+    if (queue_family_indices.graphics_family.value() == queue_family_indices.present_family.value()) {
+        create_info.imageSharingMode      = VK_SHARING_MODE_EXCLUSIVE;
+        create_info.queueFamilyIndexCount = 1;
+        create_info.pQueueFamilyIndices   = queue_family_indices_array;
+    } else {
+        create_info.imageSharingMode      = VK_SHARING_MODE_CONCURRENT;
+        create_info.queueFamilyIndexCount = 2;
+        create_info.pQueueFamilyIndices   = queue_family_indices_array;
+    }
+
+    create_info.preTransform   = support_details.capabilities.currentTransform;
+    create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    create_info.presentMode    = present_mode;
+    create_info.clipped        = VK_TRUE;
+    create_info.oldSwapchain   = VK_NULL_HANDLE;
+
+    if (vkCreateSwapchainKHR(m_context->device(), &create_info, nullptr, &m_swapchain) != VK_SUCCESS) {
+        throw std::runtime_error("Swapchain::create_swapchain => failed to create swap chain!");
+    }
+
+    vkGetSwapchainImagesKHR(m_context->device(), m_swapchain, &image_count, nullptr);
+    m_images.resize(image_count);
+    vkGetSwapchainImagesKHR(m_context->device(), m_swapchain, &image_count, m_images.data());
+
+    m_format = surface_format.format;
+    m_extent = extent;
+}
+
+void Swapchain::create_offscreen_images(uint32_t image_count) {
+    VkDevice device = m_context->device();
+
+    m_images.resize(image_count);
+    m_offscreen_image_memory.resize(image_count);
+
+    for (uint32_t i = 0; i < image_count; ++i) {
+        VkImageCreateInfo image_create_info{};
+        image_create_info.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_create_info.imageType     = VK_IMAGE_TYPE_2D;
+        image_create_info.format        = m_format;
+        image_create_info.extent        = {m_extent.width, m_extent.height, 1};
+        image_create_info.mipLevels     = 1;
+        image_create_info.arrayLayers   = 1;
+        image_create_info.samples       = VK_SAMPLE_COUNT_1_BIT;
+        image_create_info.tiling        = VK_IMAGE_TILING_OPTIMAL;
+        image_create_info.usage         = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        image_create_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+        image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (vkCreateImage(device, &image_create_info, nullptr, &m_images[i]) != VK_SUCCESS) {
+            throw std::runtime_error("Swapchain::create_offscreen_images => failed to create offscreen image!");
+        }
+
+        VkMemoryRequirements memory_requirements;
+        vkGetImageMemoryRequirements(device, m_images[i], &memory_requirements);
+
+        m_offscreen_image_memory[i] =
+            m_context->allocator().allocate(memory_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        vkBindImageMemory(device, m_images[i], m_offscreen_image_memory[i].memory, m_offscreen_image_memory[i].offset);
+    }
+}
+
+void Swapchain::create_image_views() {
+    m_image_views.resize(m_images.size());
+
+    for (size_t i = 0; i < m_image_views.size(); ++i) {
+        VkImageViewCreateInfo create_info           = {};
+        create_info.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        create_info.image                           = m_images[i];
+        create_info.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
+        create_info.format                          = m_format;
+        create_info.components.r                    = VK_COMPONENT_SWIZZLE_IDENTITY;
+        create_info.components.g                    = VK_COMPONENT_SWIZZLE_IDENTITY;
+        create_info.components.b                    = VK_COMPONENT_SWIZZLE_IDENTITY;
+        create_info.components.a                    = VK_COMPONENT_SWIZZLE_IDENTITY;
+        create_info.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        create_info.subresourceRange.baseMipLevel   = 0;
+        create_info.subresourceRange.levelCount     = 1;
+        create_info.subresourceRange.baseArrayLayer = 0;
+        create_info.subresourceRange.layerCount     = 1;
+
+        if (vkCreateImageView(m_context->device(), &create_info, nullptr, &m_image_views[i]) != VK_SUCCESS) {
+            throw std::runtime_error("Swapchain::create_image_views => failed to create image views!");
+        }
+    }
+}
+
+void Swapchain::create_render_finished_semaphores() {
+    m_semaphores_render_finished.resize(m_images.size(), VK_NULL_HANDLE);
+
+    VkSemaphoreCreateInfo semaphore_create_info{};
+    semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    for (size_t i = 0; i < m_semaphores_render_finished.size(); ++i) {
+        if (vkCreateSemaphore(m_context->device(), &semaphore_create_info, nullptr, &m_semaphores_render_finished[i]) !=
+            VK_SUCCESS) {
+            throw std::runtime_error(
+                "Swapchain::create_render_finished_semaphores => failed to create render-finished semaphore!");
+        }
+    }
+}
+
+VkSurfaceFormatKHR Swapchain::choose_swapchain_surface_format(const std::vector<VkSurfaceFormatKHR>& formats) {
+    for (const auto& format : formats) {
+        if (format.format == VK_FORMAT_B8G8R8A8_SRGB && format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
+            return format;
+        }
+    }
+
+    if (!formats.empty()) {
+        return formats[0];
+    }
+
+    throw std::runtime_error(
+        "Swapchain::choose_swapchain_surface_format => Failed to find a suitable "
+        "swap chain surface format.");
+}
+
+VkPresentModeKHR Swapchain::choose_swapchain_present_mode(const std::vector<VkPresentModeKHR>& present_modes) {
+    for (const auto& present_mode : present_modes) {
+        if (present_mode == VK_PRESENT_MODE_MAILBOX_KHR) {
+            return present_mode;
+        }
+    }
+
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+VkExtent2D Swapchain::choose_swapchain_extent(const VkSurfaceCapabilitiesKHR& capabilities) {
+    if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
+        return capabilities.currentExtent;
+    } else {
+        int width{};
+        int height{};
+
+        glfwGetFramebufferSize(m_context->window(), &width, &height);
+        VkExtent2D extent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+
+        extent.width  = std::clamp(extent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
+        extent.height =
+            std::clamp(extent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+
+        return extent;
+    }
+}
+
+}  // namespace renderer
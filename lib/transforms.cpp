@@ -0,0 +1,283 @@
+#include "transforms.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "simd.hpp"
+
+namespace math {
+
+/* ---- TransformSoA ---- */
+
+void TransformSoA::reserve(size_t capacity) {
+    if (capacity <= m_capacity) {
+        return;
+    }
+
+    size_t new_capacity = (capacity + FLOATS_PER_LINE - 1) / FLOATS_PER_LINE * FLOATS_PER_LINE;
+
+    void* storage = ::operator new[](new_capacity * STREAM_COUNT * sizeof(float), std::align_val_t{ALIGNMENT});
+    std::unique_ptr<float[], AlignedDelete> data(static_cast<float*>(storage));
+
+    for (size_t stream = 0; stream < STREAM_COUNT; ++stream) {
+        if (m_size > 0) {
+            std::memcpy(data.get() + stream * new_capacity, m_data.get() + stream * m_capacity, m_size * sizeof(float));
+        }
+    }
+
+    m_data     = std::move(data);
+    m_capacity = new_capacity;
+}
+
+void TransformSoA::resize(size_t size) {
+    reserve(size);
+
+    for (size_t i = m_size; i < size; ++i) {
+        set(i, Transform{});
+    }
+
+    m_size = size;
+}
+
+void TransformSoA::push_back(const Transform& transform) {
+    if (m_size == m_capacity) {
+        reserve(std::max<size_t>(m_capacity * 2, FLOATS_PER_LINE));
+    }
+
+    set(m_size++, transform);
+}
+
+void TransformSoA::set(size_t index, const Transform& transform) {
+    stream(TransformStream::PositionX)[index] = transform.position.x;
+    stream(TransformStream::PositionY)[index] = transform.position.y;
+    stream(TransformStream::PositionZ)[index] = transform.position.z;
+    stream(TransformStream::RotationX)[index] = transform.rotation.x;
+    stream(TransformStream::RotationY)[index] = transform.rotation.y;
+    stream(TransformStream::RotationZ)[index] = transform.rotation.z;
+    stream(TransformStream::RotationW)[index] = transform.rotation.w;
+    stream(TransformStream::ScaleX)[index]    = transform.scale.x;
+    stream(TransformStream::ScaleY)[index]    = transform.scale.y;
+    stream(TransformStream::ScaleZ)[index]    = transform.scale.z;
+}
+
+Transform TransformSoA::get(size_t index) const {
+    Transform transform;
+    transform.position = {stream(TransformStream::PositionX)[index], stream(TransformStream::PositionY)[index],
+                          stream(TransformStream::PositionZ)[index]};
+    transform.rotation = {stream(TransformStream::RotationX)[index], stream(TransformStream::RotationY)[index],
+                          stream(TransformStream::RotationZ)[index], stream(TransformStream::RotationW)[index]};
+    transform.scale    = {stream(TransformStream::ScaleX)[index], stream(TransformStream::ScaleY)[index],
+                          stream(TransformStream::ScaleZ)[index]};
+    return transform;
+}
+
+/* ---- World matrix kernels ---- */
+
+namespace {
+
+// The ten component streams, offset to the first transform of a batch.
+class StreamPointers {
+   public:
+    const float* px;
+    const float* py;
+    const float* pz;
+    const float* qx;
+    const float* qy;
+    const float* qz;
+    const float* qw;
+    const float* sx;
+    const float* sy;
+    const float* sz;
+
+    StreamPointers(const TransformSoA& transforms, size_t first)
+        : px(transforms.stream(TransformStream::PositionX) + first),
+          py(transforms.stream(TransformStream::PositionY) + first),
+          pz(transforms.stream(TransformStream::PositionZ) + first),
+          qx(transforms.stream(TransformStream::RotationX) + first),
+          qy(transforms.stream(TransformStream::RotationY) + first),
+          qz(transforms.stream(TransformStream::RotationZ) + first),
+          qw(transforms.stream(TransformStream::RotationW) + first),
+          sx(transforms.stream(TransformStream::ScaleX) + first),
+          sy(transforms.stream(TransformStream::ScaleY) + first),
+          sz(transforms.stream(TransformStream::ScaleZ) + first) {}
+};
+
+// One lane of the vector kernel below, also used for the tail.
+inline void world_matrix_scalar(const StreamPointers& s, size_t i, Mat4& out) {
+    out = trs({s.px[i], s.py[i], s.pz[i]}, {s.qx[i], s.qy[i], s.qz[i], s.qw[i]}, {s.sx[i], s.sy[i], s.sz[i]});
+}
+
+#if defined(MATH_SIMD_AVX2) || defined(MATH_SIMD_SSE) || defined(MATH_SIMD_NEON)
+
+// Thin wrappers so the kernel is written once for every instruction set. V::WIDTH transforms are processed per step.
+// store() transposes the component-major registers, columns[column][component], into V::WIDTH matrices and writes
+// each matrix as one contiguous 64-byte run, which keeps write-combined mapped memory streaming full lines.
+#if defined(MATH_SIMD_AVX2)
+class V {
+   public:
+    static constexpr size_t WIDTH = 8;
+
+    __m256 value;
+
+    static V load(const float* data) { return {_mm256_loadu_ps(data)}; }
+    static V broadcast(float value) { return {_mm256_set1_ps(value)}; }
+
+    friend V operator+(V a, V b) { return {_mm256_add_ps(a.value, b.value)}; }
+    friend V operator-(V a, V b) { return {_mm256_sub_ps(a.value, b.value)}; }
+    friend V operator*(V a, V b) { return {_mm256_mul_ps(a.value, b.value)}; }
+
+    // 4x4 transposes within each 128-bit lane: the low lane yields matrices 0-3, the high lane matrices 4-7.
+    static void store(Mat4* out, const V columns[4][4]) {
+        __m256 transposed[4][4];
+        for (int column = 0; column < 4; ++column) {
+            __m256 xy_low  = _mm256_unpacklo_ps(columns[column][0].value, columns[column][1].value);
+            __m256 xy_high = _mm256_unpackhi_ps(columns[column][0].value, columns[column][1].value);
+            __m256 zw_low  = _mm256_unpacklo_ps(columns[column][2].value, columns[column][3].value);
+            __m256 zw_high = _mm256_unpackhi_ps(columns[column][2].value, columns[column][3].value);
+
+            transposed[column][0] = _mm256_shuffle_ps(xy_low, zw_low, _MM_SHUFFLE(1, 0, 1, 0));
+            transposed[column][1] = _mm256_shuffle_ps(xy_low, zw_low, _MM_SHUFFLE(3, 2, 3, 2));
+            transposed[column][2] = _mm256_shuffle_ps(xy_high, zw_high, _MM_SHUFFLE(1, 0, 1, 0));
+            transposed[column][3] = _mm256_shuffle_ps(xy_high, zw_high, _MM_SHUFFLE(3, 2, 3, 2));
+        }
+
+        // Columns 0/1 and 2/3 of one matrix sit in the same lane of two registers.
+        for (int i = 0; i < 4; ++i) {
+            __m256 low_01  = _mm256_permute2f128_ps(transposed[0][i], transposed[1][i], 0x20);
+            __m256 low_23  = _mm256_permute2f128_ps(transposed[2][i], transposed[3][i], 0x20);
+            __m256 high_01 = _mm256_permute2f128_ps(transposed[0][i], transposed[1][i], 0x31);
+            __m256 high_23 = _mm256_permute2f128_ps(transposed[2][i], transposed[3][i], 0x31);
+
+            _mm256_storeu_ps(&out[i].columns[0].x, low_01);
+            _mm256_storeu_ps(&out[i].columns[2].x, low_23);
+            _mm256_storeu_ps(&out[i + 4].columns[0].x, high_01);
+            _mm256_storeu_ps(&out[i + 4].columns[2].x, high_23);
+        }
+    }
+};
+#elif defined(MATH_SIMD_SSE)
+class V {
+   public:
+    static constexpr size_t WIDTH = 4;
+
+    __m128 value;
+
+    static V load(const float* data) { return {_mm_loadu_ps(data)}; }
+    static V broadcast(float value) { return {_mm_set1_ps(value)}; }
+
+    friend V operator+(V a, V b) { return {_mm_add_ps(a.value, b.value)}; }
+    friend V operator-(V a, V b) { return {_mm_sub_ps(a.value, b.value)}; }
+    friend V operator*(V a, V b) { return {_mm_mul_ps(a.value, b.value)}; }
+
+    static void store(Mat4* out, const V columns[4][4]) {
+        __m128 transposed[4][4];
+        for (int column = 0; column < 4; ++column) {
+            for (int component = 0; component < 4; ++component) {
+                transposed[column][component] = columns[column][component].value;
+            }
+            _MM_TRANSPOSE4_PS(transposed[column][0], transposed[column][1], transposed[column][2],
+                              transposed[column][3]);
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            for (int column = 0; column < 4; ++column) {
+                _mm_store_ps(&out[i].columns[column].x, transposed[column][i]);
+            }
+        }
+    }
+};
+#elif defined(MATH_SIMD_NEON)
+class V {
+   public:
+    static constexpr size_t WIDTH = 4;
+
+    float32x4_t value;
+
+    static V load(const float* data) { return {vld1q_f32(data)}; }
+    static V broadcast(float value) { return {vdupq_n_f32(value)}; }
+
+    friend V operator+(V a, V b) { return {vaddq_f32(a.value, b.value)}; }
+    friend V operator-(V a, V b) { return {vsubq_f32(a.value, b.value)}; }
+    friend V operator*(V a, V b) { return {vmulq_f32(a.value, b.value)}; }
+
+    // vst4q interleaves the four component registers, which is exactly the transpose of one column.
+    static void store(Mat4* out, const V columns[4][4]) {
+        float transposed[4][4][4];
+        for (int column = 0; column < 4; ++column) {
+            vst4q_f32(&transposed[column][0][0], float32x4x4_t{{columns[column][0].value, columns[column][1].value,
+                                                                 columns[column][2].value, columns[column][3].value}});
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            for (int column = 0; column < 4; ++column) {
+                vst1q_f32(&out[i].columns[column].x, vld1q_f32(transposed[column][i]));
+            }
+        }
+    }
+};
+#endif
+
+// trs() evaluated for V::WIDTH transforms at once, see to_mat3(Quat).
+inline void world_matrices_vector(const StreamPointers& s, size_t i, Mat4* out) {
+    const V one  = V::broadcast(1.0f);
+    const V two  = V::broadcast(2.0f);
+    const V zero = V::broadcast(0.0f);
+
+    V qx = V::load(s.qx + i), qy = V::load(s.qy + i), qz = V::load(s.qz + i), qw = V::load(s.qw + i);
+    V sx = V::load(s.sx + i), sy = V::load(s.sy + i), sz = V::load(s.sz + i);
+
+    V xx = qx * qx, yy = qy * qy, zz = qz * qz;
+    V xy = qx * qy, xz = qx * qz, yz = qy * qz;
+    V wx = qw * qx, wy = qw * qy, wz = qw * qz;
+
+    const V columns[4][4] = {
+        {(one - two * (yy + zz)) * sx, two * (xy + wz) * sx, two * (xz - wy) * sx, zero},
+        {two * (xy - wz) * sy, (one - two * (xx + zz)) * sy, two * (yz + wx) * sy, zero},
+        {two * (xz + wy) * sz, two * (yz - wx) * sz, (one - two * (xx + yy)) * sz, zero},
+        {V::load(s.px + i), V::load(s.py + i), V::load(s.pz + i), one},
+    };
+    V::store(out, columns);
+}
+
+#endif
+
+}  // namespace
+
+void compute_world_matrices(const TransformSoA& transforms, size_t first, std::span<Mat4> out) {
+    const size_t         count = std::min(out.size(), transforms.size() - std::min(first, transforms.size()));
+    const StreamPointers streams(transforms, first);
+    size_t               i = 0;
+
+#if defined(MATH_SIMD_AVX2) || defined(MATH_SIMD_SSE) || defined(MATH_SIMD_NEON)
+    for (; i + V::WIDTH <= count; i += V::WIDTH) {
+        world_matrices_vector(streams, i, &out[i]);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        world_matrix_scalar(streams, i, out[i]);
+    }
+}
+
+void compute_world_matrices(std::span<const Transform> transforms, std::span<Mat4> out) {
+    const size_t count = std::min(transforms.size(), out.size());
+
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = trs(transforms[i].position, transforms[i].rotation, transforms[i].scale);
+    }
+}
+
+namespace scalar {
+
+void compute_world_matrices(const TransformSoA& transforms, size_t first, std::span<Mat4> out) {
+    const size_t         count = std::min(out.size(), transforms.size() - std::min(first, transforms.size()));
+    const StreamPointers streams(transforms, first);
+
+    for (size_t i = 0; i < count; ++i) {
+        world_matrix_scalar(streams, i, out[i]);
+    }
+}
+
+}  // namespace scalar
+
+}  // namespace math
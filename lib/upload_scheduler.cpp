@@ -0,0 +1,278 @@
+#include "upload_scheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace renderer {
+
+void UploadScheduler::init(const DeviceContext& context, bool allow_async, VkDeviceSize batch_size) {
+    m_context         = &context;
+    m_batch_size      = batch_size;
+    m_graphics_family = context.queue_family_indices().graphics_family.value();
+    m_stats           = {};
+
+    // Ordering batches against frames on another queue needs a semaphore the host never has to reset.
+    uint32_t transfer_family = context.queue_family_indices().transfer_family.value();
+    m_async = allow_async && transfer_family != m_graphics_family && context.features().timeline_semaphore;
+
+    m_queue_family = m_async ? transfer_family : m_graphics_family;
+    m_queue        = m_async ? context.transfer_queue() : context.graphics_queue();
+
+    VkDevice device = context.device();
+
+    VkCommandPoolCreateInfo command_pool_create_info{};
+    command_pool_create_info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    command_pool_create_info.queueFamilyIndex = m_queue_family;
+    command_pool_create_info.flags =
+        VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+    if (vkCreateCommandPool(device, &command_pool_create_info, nullptr, &m_command_pool) != VK_SUCCESS) {
+        throw std::runtime_error("UploadScheduler::init => failed to create command pool!");
+    }
+
+    for (Batch& batch : m_batches) {
+        VkCommandBufferAllocateInfo command_buffer_allocate_info{};
+        command_buffer_allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        command_buffer_allocate_info.commandPool        = m_command_pool;
+        command_buffer_allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        command_buffer_allocate_info.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(device, &command_buffer_allocate_info, &batch.command_buffer) != VK_SUCCESS) {
+            throw std::runtime_error("UploadScheduler::init => failed to allocate command buffer!");
+        }
+
+        VkFenceCreateInfo fence_create_info{};
+        fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        if (vkCreateFence(device, &fence_create_info, nullptr, &batch.fence) != VK_SUCCESS) {
+            throw std::runtime_error("UploadScheduler::init => failed to create fence!");
+        }
+    }
+
+    if (m_async) {
+        VkSemaphoreTypeCreateInfo semaphore_type_create_info{};
+        semaphore_type_create_info.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        semaphore_type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphore_type_create_info.initialValue  = 0;
+
+        VkSemaphoreCreateInfo timeline_create_info{};
+        timeline_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        timeline_create_info.pNext = &semaphore_type_create_info;
+
+        if (vkCreateSemaphore(device, &timeline_create_info, nullptr, &m_timeline) != VK_SUCCESS) {
+            throw std::runtime_error("UploadScheduler::init => failed to create the upload timeline semaphore!");
+        }
+    }
+
+    m_staging_buffer = create_buffer(context, m_batch_size * BATCH_COUNT, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
+void UploadScheduler::cleanup() {
+    VkDevice device = m_context->device();
+
+    // Batches still in flight reference the staging buffer.
+    for (Batch& batch : m_batches) {
+        if (batch.in_flight) {
+            vkWaitForFences(device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        }
+        vkDestroyFence(device, batch.fence, nullptr);
+
+        batch = {};
+    }
+
+    destroy_buffer(*m_context, m_staging_buffer);
+    vkDestroySemaphore(device, m_timeline, nullptr);
+    vkDestroyCommandPool(device, m_command_pool, nullptr);
+
+    m_timeline        = VK_NULL_HANDLE;
+    m_command_pool    = VK_NULL_HANDLE;
+    m_submitted_value = 0;
+    m_current_batch   = 0;
+    m_pending_acquires.clear();
+}
+
+void UploadScheduler::upload(VkBuffer dst_buffer, VkDeviceSize dst_offset, const void* data, VkDeviceSize size) {
+    const auto* bytes = static_cast<const std::byte*>(data);
+
+    m_stats.uploads++;
+    m_stats.bytes += size;
+
+    for (VkDeviceSize offset = 0; offset < size;) {
+        Batch& batch = open_batch();
+        if (batch.used == m_batch_size) {
+            flush();
+            continue;
+        }
+
+        VkDeviceSize chunk_size     = std::min(m_batch_size - batch.used, size - offset);
+        VkDeviceSize staging_offset = m_current_batch * m_batch_size + batch.used;
+
+        std::memcpy(static_cast<std::byte*>(m_staging_buffer.allocation.mapped) + staging_offset, bytes + offset,
+                    static_cast<size_t>(chunk_size));
+
+        VkBufferCopy copy_region{};
+        copy_region.srcOffset = staging_offset;
+        copy_region.dstOffset = dst_offset + offset;
+        copy_region.size      = chunk_size;
+        vkCmdCopyBuffer(batch.command_buffer, m_staging_buffer.buffer, dst_buffer, 1, &copy_region);
+
+        // Consecutive chunks of one upload (or back-to-back uploads) become a single barrier.
+        if (!batch.ranges.empty() && batch.ranges.back().buffer == dst_buffer &&
+            batch.ranges.back().offset + batch.ranges.back().size == copy_region.dstOffset) {
+            batch.ranges.back().size += chunk_size;
+        } else {
+            batch.ranges.push_back({dst_buffer, copy_region.dstOffset, chunk_size});
+        }
+
+        batch.used = std::min(m_batch_size, (batch.used + chunk_size + COPY_ALIGNMENT - 1) & ~(COPY_ALIGNMENT - 1));
+        offset += chunk_size;
+    }
+}
+
+void UploadScheduler::flush() {
+    Batch& batch = m_batches[m_current_batch];
+    if (!batch.recording) {
+        return;
+    }
+
+    if (m_async) {
+        record_release_barriers(batch);
+    }
+
+    if (vkEndCommandBuffer(batch.command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("UploadScheduler::flush => failed to record command buffer!");
+    }
+
+    VkSubmitInfo submit_info{};
+    submit_info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers    = &batch.command_buffer;
+
+    uint64_t                      signal_value = m_submitted_value + 1;
+    VkTimelineSemaphoreSubmitInfo timeline_submit_info{};
+    if (m_async) {
+        timeline_submit_info.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_submit_info.signalSemaphoreValueCount = 1;
+        timeline_submit_info.pSignalSemaphoreValues    = &signal_value;
+
+        submit_info.pNext                = &timeline_submit_info;
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores    = &m_timeline;
+    }
+
+    if (vkQueueSubmit(m_queue, 1, &submit_info, batch.fence) != VK_SUCCESS) {
+        throw std::runtime_error("UploadScheduler::flush => failed to submit upload batch!");
+    }
+
+    m_submitted_value = signal_value;
+    m_pending_acquires.insert(m_pending_acquires.end(), batch.ranges.begin(), batch.ranges.end());
+    batch.ranges.clear();
+    batch.recording = false;
+    batch.in_flight = true;
+    m_stats.batches++;
+
+    m_current_batch = (m_current_batch + 1) % BATCH_COUNT;
+}
+
+void UploadScheduler::acquire(VkCommandBuffer command_buffer, FrameScheduler& frame_scheduler) {
+    if (m_pending_acquires.empty()) {
+        return;
+    }
+
+    if (!m_async) {
+        // Same queue, earlier submission: a memory barrier orders the copies before every later command.
+        VkMemoryBarrier memory_barrier{};
+        memory_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memory_barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1,
+                             &memory_barrier, 0, nullptr, 0, nullptr);
+        m_pending_acquires.clear();
+        return;
+    }
+
+    // Each acquire mirrors a release recorded by flush(); the semaphore wait below orders it after the release.
+    std::vector<VkBufferMemoryBarrier> buffer_barriers(m_pending_acquires.size());
+    for (size_t i = 0; i < m_pending_acquires.size(); ++i) {
+        VkBufferMemoryBarrier& buffer_barrier = buffer_barriers[i];
+        buffer_barrier.sType                  = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        buffer_barrier.srcAccessMask          = 0;
+        buffer_barrier.dstAccessMask          = VK_ACCESS_MEMORY_READ_BIT;
+        buffer_barrier.srcQueueFamilyIndex    = m_queue_family;
+        buffer_barrier.dstQueueFamilyIndex    = m_graphics_family;
+        buffer_barrier.buffer                 = m_pending_acquires[i].buffer;
+        buffer_barrier.offset                 = m_pending_acquires[i].offset;
+        buffer_barrier.size                   = m_pending_acquires[i].size;
+    }
+
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0,
+                         nullptr, static_cast<uint32_t>(buffer_barriers.size()), buffer_barriers.data(), 0, nullptr);
+
+    frame_scheduler.add_wait({m_timeline, m_submitted_value, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT});
+    m_pending_acquires.clear();
+}
+
+UploadScheduler::Batch& UploadScheduler::open_batch() {
+    Batch& batch = m_batches[m_current_batch];
+    if (batch.recording) {
+        return batch;
+    }
+
+    VkDevice device = m_context->device();
+
+    // The batch's staging region is still being read by a previous submission.
+    if (batch.in_flight) {
+        if (vkGetFenceStatus(device, batch.fence) != VK_SUCCESS) {
+            auto wait_start = std::chrono::steady_clock::now();
+            vkWaitForFences(device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+            auto wait_end = std::chrono::steady_clock::now();
+
+            m_stats.host_waits++;
+            m_stats.wait_ms += std::chrono::duration<double, std::milli>(wait_end - wait_start).count();
+        }
+        vkResetFences(device, 1, &batch.fence);
+        batch.in_flight = false;
+    }
+
+    vkResetCommandBuffer(batch.command_buffer, 0);
+
+    VkCommandBufferBeginInfo command_buffer_begin_info{};
+    command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(batch.command_buffer, &command_buffer_begin_info) != VK_SUCCESS) {
+        throw std::runtime_error("UploadScheduler::open_batch => failed to begin recording command buffer!");
+    }
+
+    batch.used      = 0;
+    batch.recording = true;
+
+    return batch;
+}
+
+void UploadScheduler::record_release_barriers(const Batch& batch) {
+    // Destination buffers are EXCLUSIVE, so the graphics family has to take ownership before it may read them.
+    std::vector<VkBufferMemoryBarrier> buffer_barriers(batch.ranges.size());
+    for (size_t i = 0; i < batch.ranges.size(); ++i) {
+        VkBufferMemoryBarrier& buffer_barrier = buffer_barriers[i];
+        buffer_barrier.sType                  = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        buffer_barrier.srcAccessMask          = VK_ACCESS_TRANSFER_WRITE_BIT;
+        buffer_barrier.dstAccessMask          = 0;
+        buffer_barrier.srcQueueFamilyIndex    = m_queue_family;
+        buffer_barrier.dstQueueFamilyIndex    = m_graphics_family;
+        buffer_barrier.buffer                 = batch.ranges[i].buffer;
+        buffer_barrier.offset                 = batch.ranges[i].offset;
+        buffer_barrier.size                   = batch.ranges[i].size;
+    }
+
+    vkCmdPipelineBarrier(batch.command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                         0, nullptr, static_cast<uint32_t>(buffer_barriers.size()), buffer_barriers.data(), 0,
+                         nullptr);
+}
+
+}  // namespace renderer
@@ -0,0 +1,31 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
+
+// Every storage buffer of the BindlessTable (set 0, binding 0), read as tightly packed floats.
+layout(std430, set = 0, binding = 0) readonly buffer Floats {
+    float data[];
+} buffers[];
+
+// Matches BindlessPushConstants in apps/vertex_buffers/main.cpp.
+layout(push_constant) uniform Bindless {
+    uint instanceBuffer;
+    uint instanceBase;
+} pc;
+
+layout(location = 0) out vec3 fragColor;
+
+void main() {
+    // InstanceData is vec2 offset, vec3 color, float scale without padding: 6 floats per instance.
+    uint base = pc.instanceBase + uint(gl_InstanceIndex) * 6u;
+
+    vec2  offset = vec2(buffers[pc.instanceBuffer].data[base], buffers[pc.instanceBuffer].data[base + 1u]);
+    vec3  color  = vec3(buffers[pc.instanceBuffer].data[base + 2u], buffers[pc.instanceBuffer].data[base + 3u],
+                        buffers[pc.instanceBuffer].data[base + 4u]);
+    float scale  = buffers[pc.instanceBuffer].data[base + 5u];
+
+    gl_Position = vec4(inPosition * scale + offset, 0.0, 1.0);
+    fragColor = inColor * color;
+}
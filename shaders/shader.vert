@@ -3,9 +3,14 @@
 layout(location = 0) in vec2 inPosition;
 layout(location = 1) in vec3 inColor;
 
+// Per-instance attributes (binding 1, VK_VERTEX_INPUT_RATE_INSTANCE).
+layout(location = 2) in vec2 inInstanceOffset;
+layout(location = 3) in vec3 inInstanceColor;
+layout(location = 4) in float inInstanceScale;
+
 layout(location = 0) out vec3 fragColor;
 
 void main() {
-    gl_Position = vec4(inPosition, 0.0, 1.0);
-    fragColor = inColor;
+    gl_Position = vec4(inPosition * inInstanceScale + inInstanceOffset, 0.0, 1.0);
+    fragColor = inColor * inInstanceColor;
 }
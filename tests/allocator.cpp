@@ -0,0 +1,323 @@
+// Asserts must stay live in the release and lto configurations, which build with -DNDEBUG.
+#undef NDEBUG
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "allocator.hpp"
+
+// CPU-only allocator tests against MockMemoryBackend, so they run without a GPU.
+
+namespace {
+
+constexpr uint32_t DEVICE_LOCAL = 0;
+constexpr uint32_t HOST_VISIBLE = 1;
+
+constexpr VkDeviceSize BLOCK_SIZE = 4096;
+
+VkPhysicalDeviceMemoryProperties mock_memory_properties() {
+    VkPhysicalDeviceMemoryProperties memory_properties{};
+    memory_properties.memoryTypeCount                         = 2;
+    memory_properties.memoryTypes[DEVICE_LOCAL].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    memory_properties.memoryTypes[HOST_VISIBLE].propertyFlags =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    return memory_properties;
+}
+
+VkMemoryRequirements requirements(VkDeviceSize size, VkDeviceSize alignment = 1, uint32_t memory_type = DEVICE_LOCAL) {
+    VkMemoryRequirements memory_requirements{};
+    memory_requirements.size           = size;
+    memory_requirements.alignment      = alignment;
+    memory_requirements.memoryTypeBits = 1u << memory_type;
+
+    return memory_requirements;
+}
+
+// Allocates like the mock but refuses every map, to exercise the allocator's error path.
+class UnmappableMemoryBackend : public renderer::MockMemoryBackend {
+   public:
+    VkResult map(VkDeviceMemory memory, VkDeviceSize size, void** data) override {
+        (void)memory;
+        (void)size;
+        (void)data;
+
+        return VK_ERROR_MEMORY_MAP_FAILED;
+    }
+};
+
+/* ---- Offset allocators ---- */
+
+void test_buddy_split_and_merge() {
+    renderer::BuddyAllocator buddy;
+    buddy.init(256, 4);
+
+    assert(buddy.size() == 4096);
+    assert(buddy.largest_free() == 4096);
+
+    // The first minimum-sized request splits the root all the way down.
+    auto a = buddy.allocate(0);
+    auto b = buddy.allocate(0);
+    auto c = buddy.allocate(1);
+    assert(a && b && c);
+    assert(*a == 0 && *b == 256 && *c == 512);
+    assert(buddy.used() == 256 + 256 + 512);
+    assert(buddy.largest_free() == 2048);
+
+    buddy.free(*b, 0);
+    buddy.free(*a, 0);
+    assert(buddy.largest_free() == 2048);
+
+    // Freeing the last node merges every buddy pair back into a single free root.
+    buddy.free(*c, 1);
+    assert(buddy.empty());
+    assert(buddy.largest_free() == 4096);
+
+    auto root = buddy.allocate(4);
+    assert(root && *root == 0);
+    assert(!buddy.allocate(0));
+    assert(!buddy.allocate(5));
+}
+
+void test_buddy_alignment() {
+    renderer::BuddyAllocator buddy;
+    buddy.init(256, 4);
+
+    assert(buddy.order_for(1, 1) == 0);
+    assert(buddy.order_for(257, 1) == 1);
+    assert(buddy.order_for(100, 1024) == 2);
+
+    auto small   = buddy.allocate(0);
+    auto aligned = buddy.allocate(buddy.order_for(100, 1024));
+    assert(small && aligned);
+    assert(*aligned % 1024 == 0);
+    assert(*aligned != *small);
+}
+
+void test_linear_reset() {
+    renderer::LinearAllocator linear;
+    linear.init(1024);
+
+    auto a = linear.allocate(10, 1);
+    auto b = linear.allocate(10, 64);
+    assert(a && b);
+    assert(*a == 0 && *b == 64);
+
+    auto c = linear.allocate(1024 - 74, 1);
+    assert(c && *c == 74);
+    assert(!linear.allocate(1, 1));
+
+    // Individual frees only count down; the range comes back once nothing is live.
+    linear.free(10);
+    linear.free(10);
+    assert(!linear.empty());
+    assert(linear.largest_free() == 0);
+
+    linear.free(1024 - 74);
+    assert(linear.empty());
+    assert(linear.used() == 0);
+    assert(linear.largest_free() == 1024);
+
+    auto d = linear.allocate(1024, 1);
+    assert(d && *d == 0);
+}
+
+/* ---- Device allocator ---- */
+
+void test_granularity() {
+    renderer::MockMemoryBackend backend;
+    renderer::DeviceAllocator   allocator;
+    allocator.init(backend, mock_memory_properties(), 1024, BLOCK_SIZE);
+
+    renderer::Allocation a = allocator.allocate(requirements(16, 4), 0, renderer::AllocationStrategy::Linear);
+    renderer::Allocation b = allocator.allocate(requirements(16, 4), 0, renderer::AllocationStrategy::Linear);
+    renderer::Allocation c = allocator.allocate(requirements(16, 256), 0);
+
+    assert(a.memory == b.memory);
+    assert(a.offset == 0 && b.offset == 1024);
+    assert(c.offset % 1024 == 0);
+    assert(c.strategy == renderer::AllocationStrategy::Buddy);
+    assert(backend.allocate_calls == 2);
+
+    allocator.cleanup();
+    assert(backend.live_allocation_count() == 0);
+}
+
+void test_host_visible_mapping() {
+    renderer::MockMemoryBackend backend;
+    renderer::DeviceAllocator   allocator;
+    allocator.init(backend, mock_memory_properties(), 1, BLOCK_SIZE);
+
+    VkMemoryPropertyFlags host_visible = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+
+    renderer::Allocation device_local = allocator.allocate(requirements(256), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    renderer::Allocation first        = allocator.allocate(requirements(256, 1, HOST_VISIBLE), host_visible);
+    renderer::Allocation second       = allocator.allocate(requirements(256, 1, HOST_VISIBLE), host_visible);
+
+    assert(device_local.memory_type == DEVICE_LOCAL && !device_local.mapped);
+    assert(first.memory_type == HOST_VISIBLE && first.mapped && second.mapped);
+    assert(static_cast<std::byte*>(second.mapped) - static_cast<std::byte*>(first.mapped) ==
+           static_cast<std::ptrdiff_t>(second.offset - first.offset));
+
+    allocator.cleanup();
+}
+
+void test_dedicated_threshold() {
+    renderer::MockMemoryBackend backend;
+    renderer::DeviceAllocator   allocator;
+    allocator.init(backend, mock_memory_properties(), 1, BLOCK_SIZE);
+
+    // Up to half a block is sub-allocated, anything larger gets its own backend allocation.
+    renderer::Allocation pooled    = allocator.allocate(requirements(BLOCK_SIZE / 2), 0);
+    renderer::Allocation dedicated = allocator.allocate(requirements(BLOCK_SIZE / 2 + 1), 0);
+
+    assert(pooled.block_index != renderer::Allocation::DEDICATED);
+    assert(dedicated.block_index == renderer::Allocation::DEDICATED);
+    assert(dedicated.offset == 0 && dedicated.memory != pooled.memory);
+
+    renderer::AllocatorStats stats = allocator.stats();
+    assert(stats.block_count == 1);
+    assert(stats.dedicated_count == 1);
+    assert(stats.bytes_reserved == BLOCK_SIZE + BLOCK_SIZE / 2 + 1);
+    assert(backend.live_allocation_count() == 2);
+
+    allocator.free(dedicated);
+    assert(dedicated.memory == VK_NULL_HANDLE);
+    assert(backend.live_allocation_count() == 1);
+    assert(allocator.stats().dedicated_count == 0);
+
+    allocator.free(pooled);
+    allocator.cleanup();
+    assert(backend.live_allocation_count() == 0);
+}
+
+void test_max_allocation_count() {
+    renderer::MockMemoryBackend backend(2);
+    renderer::DeviceAllocator   allocator;
+    allocator.init(backend, mock_memory_properties(), 1, BLOCK_SIZE);
+
+    renderer::Allocation block     = allocator.allocate(requirements(256), 0);
+    renderer::Allocation dedicated = allocator.allocate(requirements(BLOCK_SIZE), 0);
+    assert(backend.live_allocation_count() == 2);
+
+    // Sub-allocations from the existing block still succeed at the limit.
+    renderer::Allocation pooled = allocator.allocate(requirements(256), 0);
+    assert(pooled.memory == block.memory);
+
+    bool threw = false;
+    try {
+        allocator.allocate(requirements(BLOCK_SIZE), 0);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        allocator.allocate(requirements(256), 0, renderer::AllocationStrategy::Linear);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    assert(backend.live_allocation_count() == 2);
+    assert(allocator.stats().allocation_count == 3);
+
+    // Freeing the dedicated allocation makes room for a new backend allocation.
+    allocator.free(dedicated);
+    renderer::Allocation linear = allocator.allocate(requirements(256), 0, renderer::AllocationStrategy::Linear);
+    assert(linear.memory != VK_NULL_HANDLE);
+
+    allocator.cleanup();
+    assert(backend.live_allocation_count() == 0);
+}
+
+void test_map_failure_frees_memory() {
+    UnmappableMemoryBackend   backend;
+    renderer::DeviceAllocator allocator;
+    allocator.init(backend, mock_memory_properties(), 1, BLOCK_SIZE);
+
+    for (VkDeviceSize size : {VkDeviceSize{256}, BLOCK_SIZE}) {
+        bool threw = false;
+        try {
+            allocator.allocate(requirements(size, 1, HOST_VISIBLE), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+
+        assert(threw);
+        assert(backend.live_allocation_count() == 0);
+    }
+
+    renderer::AllocatorStats stats = allocator.stats();
+    assert(stats.block_count == 0 && stats.dedicated_count == 0 && stats.allocation_count == 0);
+}
+
+void test_stats_after_partial_frees() {
+    renderer::MockMemoryBackend backend;
+    renderer::DeviceAllocator   allocator;
+    allocator.init(backend, mock_memory_properties(), 1, BLOCK_SIZE);
+
+    std::vector<renderer::Allocation> allocations;
+    for (uint32_t i = 0; i < 4; ++i) {
+        allocations.push_back(allocator.allocate(requirements(1000), 0));
+    }
+
+    renderer::AllocatorStats stats = allocator.stats();
+    assert(stats.block_count == 1);
+    assert(stats.allocation_count == 4);
+    assert(stats.bytes_reserved == BLOCK_SIZE);
+    assert(stats.bytes_used == BLOCK_SIZE);
+    assert(stats.bytes_requested == 4000);
+    assert(stats.fragmentation == 0.0);
+
+    // Two free 1 KiB nodes that are not buddies: half the free space is unusable for a 2 KiB request.
+    allocator.free(allocations[0]);
+    allocator.free(allocations[2]);
+
+    stats = allocator.stats();
+    assert(stats.allocation_count == 2);
+    assert(stats.bytes_used == 2048);
+    assert(stats.bytes_requested == 2000);
+    assert(stats.fragmentation == 0.5);
+
+    // Freeing node 1 merges it with node 0 into a 2 KiB range next to the lone 1 KiB one.
+    allocator.free(allocations[1]);
+
+    stats = allocator.stats();
+    assert(stats.bytes_used == 1024);
+    assert(stats.fragmentation == 1.0 - 2048.0 / 3072.0);
+
+    allocator.free(allocations[3]);
+
+    stats = allocator.stats();
+    assert(stats.allocation_count == 0);
+    assert(stats.bytes_used == 0);
+    assert(stats.fragmentation == 0.0);
+    assert(stats.block_count == 1);
+
+    allocator.trim();
+    assert(allocator.stats().block_count == 0);
+    assert(backend.live_allocation_count() == 0);
+}
+
+}  // namespace
+
+int main() {
+    test_buddy_split_and_merge();
+    test_buddy_alignment();
+    test_linear_reset();
+    test_granularity();
+    test_host_visible_mapping();
+    test_dedicated_threshold();
+    test_max_allocation_count();
+    test_map_failure_frees_memory();
+    test_stats_after_partial_frees();
+
+    std::cout << "allocator => all tests passed\n";
+    return 0;
+}
@@ -0,0 +1,131 @@
+// Asserts must stay live in the release, lto and pgo configurations, which build with -DNDEBUG.
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+
+#include "frame_tracer.hpp"
+
+// LatencyHistogram bucket math; every p50/p99/p999 in the frame reports depends on it.
+
+namespace {
+
+using renderer::LatencyHistogram;
+
+constexpr uint32_t SUB_BUCKETS = 16;
+constexpr uint32_t LAST_BUCKET = (64 - 4 + 1) * SUB_BUCKETS - 1;
+
+// ns lands in a bucket whose range [previous upper bound + 1, upper bound] contains it and is at most 1/16 of ns
+// wide.
+void check_bucket(uint64_t ns) {
+    uint32_t index = LatencyHistogram::bucket_index(ns);
+    uint64_t upper = LatencyHistogram::bucket_upper_bound(index);
+
+    assert(index <= LAST_BUCKET);
+    assert(upper >= ns);
+    assert(upper - ns <= ns / SUB_BUCKETS);
+
+    if (index > 0) {
+        assert(LatencyHistogram::bucket_upper_bound(index - 1) < ns);
+    }
+    if (upper < UINT64_MAX) {
+        assert(LatencyHistogram::bucket_index(upper + 1) == index + 1);
+    }
+}
+
+void test_linear_buckets() {
+    // Below SUB_BUCKETS every value has its own bucket.
+    for (uint64_t ns = 0; ns < SUB_BUCKETS; ++ns) {
+        assert(LatencyHistogram::bucket_index(ns) == ns);
+        assert(LatencyHistogram::bucket_upper_bound(static_cast<uint32_t>(ns)) == ns);
+    }
+
+    assert(LatencyHistogram::bucket_index(15) == 15);
+    assert(LatencyHistogram::bucket_index(16) == 16);
+    assert(LatencyHistogram::bucket_index(31) == 31);
+    assert(LatencyHistogram::bucket_upper_bound(31) == 31);
+
+    // From 32 on buckets are two wide, from 64 on four wide, and so on.
+    assert(LatencyHistogram::bucket_index(32) == 32);
+    assert(LatencyHistogram::bucket_index(33) == 32);
+    assert(LatencyHistogram::bucket_upper_bound(32) == 33);
+    assert(LatencyHistogram::bucket_index(63) == 47);
+    assert(LatencyHistogram::bucket_index(64) == 48);
+    assert(LatencyHistogram::bucket_upper_bound(48) == 67);
+}
+
+void test_power_of_two_boundaries() {
+    for (uint64_t ns : {uint64_t{0}, uint64_t{15}, uint64_t{16}, uint64_t{31}, uint64_t{32}}) {
+        check_bucket(ns);
+    }
+
+    for (uint32_t k = 5; k < 64; ++k) {
+        uint64_t power = uint64_t{1} << k;
+
+        check_bucket(power - 1);
+        check_bucket(power);
+        check_bucket(power + 1);
+
+        // 2^k starts a new power of two, so it opens the first sub-bucket right after 2^k - 1.
+        assert(LatencyHistogram::bucket_index(power) == LatencyHistogram::bucket_index(power - 1) + 1);
+        assert(LatencyHistogram::bucket_index(power) % SUB_BUCKETS == 0);
+    }
+
+    check_bucket(UINT64_MAX);
+    assert(LatencyHistogram::bucket_index(UINT64_MAX) == LAST_BUCKET);
+    assert(LatencyHistogram::bucket_upper_bound(LAST_BUCKET) == UINT64_MAX);
+}
+
+void test_percentiles() {
+    LatencyHistogram empty;
+    assert(empty.percentile_ns(50.0) == 0);
+    assert(empty.min_ns() == 0 && empty.max_ns() == 0);
+
+    // 1..1000 ns once each: the exact p-th percentile is 10 * p.
+    LatencyHistogram histogram;
+    for (uint64_t ns = 1; ns <= 1000; ++ns) {
+        histogram.record(ns);
+    }
+
+    assert(histogram.count() == 1000);
+    assert(histogram.min_ns() == 1 && histogram.max_ns() == 1000);
+    assert(histogram.mean_ns() == 500.5);
+
+    assert(histogram.percentile_ns(0.0) == 1);
+    assert(histogram.percentile_ns(50.0) == 511);   // bucket [496, 511]
+    assert(histogram.percentile_ns(99.0) == 991);   // bucket [960, 991]
+    assert(histogram.percentile_ns(99.9) == 1000);  // bucket [992, 1023], clamped to the maximum
+    assert(histogram.percentile_ns(100.0) == 1000);
+
+    for (double percentile = 1.0; percentile <= 100.0; percentile += 1.0) {
+        uint64_t exact    = static_cast<uint64_t>(percentile * 10.0);
+        uint64_t reported = histogram.percentile_ns(percentile);
+
+        assert(reported >= exact);
+        assert(reported - exact <= exact / SUB_BUCKETS);
+    }
+
+    // A single outlier only moves the top of the distribution.
+    LatencyHistogram spiky;
+    for (uint32_t i = 0; i < 999; ++i) {
+        spiky.record(1000);
+    }
+    spiky.record(1'000'000'000);
+
+    assert(spiky.percentile_ns(50.0) == 1023);
+    assert(spiky.percentile_ns(99.0) == 1023);
+    assert(spiky.percentile_ns(100.0) == 1'000'000'000);
+}
+
+}  // namespace
+
+int main() {
+    test_linear_buckets();
+    test_power_of_two_boundaries();
+    test_percentiles();
+
+    std::cout << "frame_tracer => all tests passed\n";
+    return 0;
+}
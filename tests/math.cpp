@@ -0,0 +1,237 @@
+// Asserts must stay live in the release, lto and pgo configurations, which build with -DNDEBUG.
+#undef NDEBUG
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "math.hpp"
+
+// The SIMD batch kernels against their scalar:: references, and the scalar helpers against known values. A wrong lane
+// order in one of the SSE, AVX2 or NEON paths shows up here rather than only as a number in the benchmarks.
+
+namespace {
+
+constexpr float TOLERANCE = 1e-5f;
+
+// Sizes around every SIMD width and the two-at-a-time AVX2 matrix loop, so each tail length is hit.
+constexpr uint32_t BATCH_SIZES[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 1000};
+
+bool near(float a, float b, float tolerance = TOLERANCE) {
+    return std::abs(a - b) <= tolerance;
+}
+
+bool near(math::Vec4 a, math::Vec4 b, float tolerance = TOLERANCE) {
+    return near(a.x, b.x, tolerance) && near(a.y, b.y, tolerance) && near(a.z, b.z, tolerance) &&
+           near(a.w, b.w, tolerance);
+}
+
+bool near(const math::Mat4& a, const math::Mat4& b, float tolerance = TOLERANCE) {
+    for (int i = 0; i < 4; ++i) {
+        if (!near(a.columns[i], b.columns[i], tolerance)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// q and -q are the same rotation.
+bool near(math::Quat a, math::Quat b) {
+    return near(math::Vec4{a.x, a.y, a.z, a.w}, math::Vec4{b.x, b.y, b.z, b.w}) ||
+           near(math::Vec4{a.x, a.y, a.z, a.w}, math::Vec4{-b.x, -b.y, -b.z, -b.w});
+}
+
+math::Vec4 random_vec4(std::mt19937& rng) {
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    return {value(rng), value(rng), value(rng), value(rng)};
+}
+
+math::Mat4 random_mat4(std::mt19937& rng) {
+    math::Mat4 m;
+    for (math::Vec4& column : m.columns) {
+        column = random_vec4(rng);
+    }
+    return m;
+}
+
+/* ---- Batch kernels ---- */
+
+void test_transform() {
+    std::mt19937 rng(1);
+
+    // Distinct values in every lane, so swapped lanes or columns cannot cancel out.
+    math::Mat4 m;
+    m.columns[0] = {1.0f, 2.0f, 3.0f, 4.0f};
+    m.columns[1] = {5.0f, 6.0f, 7.0f, 8.0f};
+    m.columns[2] = {9.0f, 10.0f, 11.0f, 12.0f};
+    m.columns[3] = {13.0f, 14.0f, 15.0f, 16.0f};
+
+    std::array<math::Vec4, 1> point{math::Vec4{1.0f, 0.0f, -1.0f, 2.0f}};
+    std::array<math::Vec4, 1> result{};
+    math::transform(m, point, result);
+    assert(near(result[0], {18.0f, 20.0f, 22.0f, 24.0f}));
+
+    for (uint32_t size : BATCH_SIZES) {
+        math::Mat4              random = random_mat4(rng);
+        std::vector<math::Vec4> in(size);
+        for (math::Vec4& v : in) {
+            v = random_vec4(rng);
+        }
+
+        std::vector<math::Vec4> expected(size);
+        std::vector<math::Vec4> actual(size);
+        math::scalar::transform(random, in, expected);
+        math::transform(random, in, actual);
+
+        for (uint32_t i = 0; i < size; ++i) {
+            assert(near(expected[i], actual[i]));
+        }
+    }
+}
+
+void test_multiply() {
+    std::mt19937 rng(2);
+
+    for (uint32_t size : BATCH_SIZES) {
+        math::Mat4              parent = random_mat4(rng);
+        std::vector<math::Mat4> a(size);
+        std::vector<math::Mat4> b(size);
+        for (uint32_t i = 0; i < size; ++i) {
+            a[i] = random_mat4(rng);
+            b[i] = random_mat4(rng);
+        }
+
+        std::vector<math::Mat4> expected(size);
+        std::vector<math::Mat4> actual(size);
+
+        math::scalar::multiply(a, b, expected);
+        math::multiply(a, b, actual);
+        for (uint32_t i = 0; i < size; ++i) {
+            assert(near(expected[i], actual[i]));
+        }
+
+        math::scalar::multiply(parent, b, expected);
+        math::multiply(parent, b, actual);
+        for (uint32_t i = 0; i < size; ++i) {
+            assert(near(expected[i], actual[i]));
+        }
+    }
+
+    // translation * scaling applies the scale first.
+    std::array<math::Mat4, 1> scale{math::scaling({2.0f, 3.0f, 4.0f})};
+    std::array<math::Mat4, 1> result{};
+    math::multiply(math::translation({1.0f, 2.0f, 3.0f}), scale, result);
+    assert(near(result[0] * math::Vec4{1.0f, 1.0f, 1.0f, 1.0f}, {3.0f, 5.0f, 7.0f, 1.0f}));
+}
+
+/* ---- Scalar helpers ---- */
+
+void test_inverse_affine() {
+    assert(near(math::inverse_affine(math::translation({1.0f, -2.0f, 3.0f})), math::translation({-1.0f, 2.0f, -3.0f})));
+    assert(near(math::inverse_affine(math::scaling({2.0f, 4.0f, 8.0f})), math::scaling({0.5f, 0.25f, 0.125f})));
+
+    // 90 degrees about z, then (1, 2, 3): the inverse maps (1, 2, 3) back to the origin and (1, 3, 3) to +x.
+    math::Quat rotation = math::axis_angle({0.0f, 0.0f, 1.0f}, std::numbers::pi_v<float> / 2.0f);
+    math::Mat4 m        = math::trs({1.0f, 2.0f, 3.0f}, rotation, {1.0f, 1.0f, 1.0f});
+    math::Mat4 inverse  = math::inverse_affine(m);
+
+    assert(near(inverse * math::Vec4{1.0f, 2.0f, 3.0f, 1.0f}, {0.0f, 0.0f, 0.0f, 1.0f}));
+    assert(near(inverse * math::Vec4{1.0f, 3.0f, 3.0f, 1.0f}, {1.0f, 0.0f, 0.0f, 1.0f}));
+
+    std::mt19937 rng(3);
+    for (uint32_t i = 0; i < 100; ++i) {
+        math::Vec4 axis  = random_vec4(rng);
+        math::Mat4 other = math::trs({10.0f * axis.x, 10.0f * axis.y, 10.0f * axis.z},
+                                     math::axis_angle(math::normalize(math::Vec3{axis.x, axis.y, axis.z}), axis.w),
+                                     {1.5f, 0.5f, 2.0f});
+
+        assert(near(other * math::inverse_affine(other), math::Mat4{}, 1e-4f));
+        assert(near(math::inverse_affine(other) * other, math::Mat4{}, 1e-4f));
+    }
+}
+
+void test_slerp() {
+    const math::Vec3 z_axis{0.0f, 0.0f, 1.0f};
+    const float      pi = std::numbers::pi_v<float>;
+
+    math::Quat identity{};
+    math::Quat quarter = math::axis_angle(z_axis, pi / 2.0f);
+
+    assert(near(math::slerp(identity, quarter, 0.0f), identity));
+    assert(near(math::slerp(identity, quarter, 1.0f), quarter));
+    assert(near(math::slerp(identity, quarter, 0.5f), math::axis_angle(z_axis, pi / 4.0f)));
+    assert(near(math::slerp(identity, quarter, 0.25f), math::axis_angle(z_axis, pi / 8.0f)));
+
+    // -quarter is the same rotation; slerp takes the shorter arc instead of going the long way round.
+    math::Quat negated{-quarter.x, -quarter.y, -quarter.z, -quarter.w};
+    assert(near(math::slerp(identity, negated, 0.5f), math::axis_angle(z_axis, pi / 4.0f)));
+
+    // Nearly equal rotations go through the normalized lerp and still come out unit length.
+    math::Quat tiny    = math::axis_angle(z_axis, 1e-3f);
+    math::Quat halfway = math::slerp(identity, tiny, 0.5f);
+    assert(near(halfway, math::axis_angle(z_axis, 0.5e-3f)));
+    assert(near(halfway.x * halfway.x + halfway.y * halfway.y + halfway.z * halfway.z + halfway.w * halfway.w, 1.0f));
+
+    // The rotated vector moves along the arc at constant speed.
+    math::Vec3 x_axis{1.0f, 0.0f, 0.0f};
+    math::Vec3 rotated = math::rotate(math::slerp(identity, math::axis_angle(z_axis, 2.0f * pi / 3.0f), 0.5f), x_axis);
+    assert(near(rotated.x, 0.5f) && near(rotated.y, std::sqrt(3.0f) / 2.0f) && near(rotated.z, 0.0f));
+}
+
+void test_frustum_planes() {
+    // 90 degree vertical field of view, square aspect, camera at the origin looking down -z.
+    math::Mat4 projection = math::perspective(std::numbers::pi_v<float> / 2.0f, 1.0f, 1.0f, 10.0f);
+
+    std::array<math::Vec4, 6> planes = math::frustum_planes(projection);
+
+    const float s = std::sqrt(0.5f);
+    assert(near(planes[0], {s, 0.0f, -s, 0.0f}));               // left:   x >= z
+    assert(near(planes[1], {-s, 0.0f, -s, 0.0f}));              // right:  x <= -z
+    assert(near(planes[2], {0.0f, -s, -s, 0.0f}));              // top:    y <= -z, clip space y points down
+    assert(near(planes[3], {0.0f, s, -s, 0.0f}));               // bottom: y >= z
+    assert(near(planes[4], {0.0f, 0.0f, -1.0f, -1.0f}));        // near:   z <= -1
+    assert(near(planes[5], {0.0f, 0.0f, 1.0f, 10.0f}, 1e-4f));  // far:    z >= -10
+
+    auto inside = [&planes](math::Vec3 p) {
+        for (math::Vec4 plane : planes) {
+            if (plane.x * p.x + plane.y * p.y + plane.z * p.z + plane.w < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    assert(inside({0.0f, 0.0f, -5.0f}));
+    assert(inside({4.9f, -4.9f, -5.0f}));
+    assert(!inside({0.0f, 0.0f, -0.5f}));
+    assert(!inside({0.0f, 0.0f, -11.0f}));
+    assert(!inside({5.1f, 0.0f, -5.0f}));
+    assert(!inside({0.0f, -5.1f, -5.0f}));
+    assert(!inside({0.0f, 0.0f, 5.0f}));
+
+    // Moving the camera moves the planes with it.
+    math::Mat4 view = math::look_at({0.0f, 0.0f, 5.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+    planes          = math::frustum_planes(projection * view);
+
+    assert(inside({0.0f, 0.0f, 0.0f}));
+    assert(!inside({0.0f, 0.0f, 4.5f}));
+    assert(!inside({0.0f, 0.0f, -6.0f}));
+}
+
+}  // namespace
+
+int main() {
+    test_transform();
+    test_multiply();
+    test_inverse_affine();
+    test_slerp();
+    test_frustum_planes();
+
+    std::cout << "math => all tests passed, SIMD path: " << math::simd_path() << "\n";
+    return 0;
+}
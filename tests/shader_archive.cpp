@@ -0,0 +1,229 @@
+// Asserts must stay live in the release, lto and pgo configurations, which build with -DNDEBUG.
+#undef NDEBUG
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "shader_archive.hpp"
+
+// Packs a few SPIR-V blobs the way tools/shader_pack does, looks them up again, and checks that damaged archives are
+// rejected by ShaderArchive::init instead of being trusted by find() and load().
+
+namespace {
+
+const std::filesystem::path DIRECTORY = std::filesystem::temp_directory_path() / "renderer_shader_archive_test";
+
+std::vector<uint32_t> make_spirv(uint32_t word_count, uint32_t seed) {
+    std::vector<uint32_t> words(word_count);
+    for (uint32_t i = 0; i < word_count; ++i) {
+        words[i] = seed * 2654435761u + i;
+    }
+    words[0] = renderer::ShaderBlob::SPIRV_MAGIC;
+    return words;
+}
+
+std::string write_file(const std::filesystem::path& path, const std::vector<std::byte>& bytes) {
+    std::filesystem::create_directories(path.parent_path());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return path.string();
+}
+
+std::string write_spirv(const std::filesystem::path& path, const std::vector<uint32_t>& words) {
+    const auto* data = reinterpret_cast<const std::byte*>(words.data());
+    return write_file(path, std::vector<std::byte>(data, data + words.size() * sizeof(uint32_t)));
+}
+
+std::vector<std::byte> read_file(const std::string& path) {
+    std::ifstream     file(path, std::ios::binary);
+    std::vector<char> chars((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    const auto* data = reinterpret_cast<const std::byte*>(chars.data());
+    return std::vector<std::byte>(data, data + chars.size());
+}
+
+bool same_code(const renderer::ShaderBlob& blob, const std::vector<uint32_t>& words) {
+    return std::equal(blob.code().begin(), blob.code().end(), words.begin(), words.end());
+}
+
+// init() on bytes must throw with reason in the message.
+void expect_rejected(const std::vector<std::byte>& bytes, const char* reason) {
+    const std::string path = write_file(DIRECTORY / "damaged.pak", bytes);
+
+    renderer::ShaderArchive archive{};
+    bool                    threw = false;
+    try {
+        archive.init(path);
+    } catch (const std::runtime_error& e) {
+        threw = std::string(e.what()).find(reason) != std::string::npos;
+    }
+    assert(threw);
+}
+
+renderer::ShaderArchiveEntry* entries(std::vector<std::byte>& bytes) {
+    return reinterpret_cast<renderer::ShaderArchiveEntry*>(bytes.data() + sizeof(renderer::ShaderArchiveHeader));
+}
+
+/* ---- Round trip ---- */
+
+void test_pack_and_find() {
+    // Sizes that are not multiples of CODE_ALIGNMENT, so the writer has to pad between blobs.
+    const std::vector<uint32_t> vert  = make_spirv(5, 1);
+    const std::vector<uint32_t> frag  = make_spirv(37, 2);
+    const std::vector<uint32_t> comp  = make_spirv(1024, 3);
+    const std::vector<uint32_t> loose = make_spirv(9, 4);
+
+    const std::vector<std::string> inputs = {
+        write_spirv(DIRECTORY / "shaders" / "test.vert.spv", vert),
+        write_spirv(DIRECTORY / "shaders" / "test.frag.spv", frag),
+        write_spirv(DIRECTORY / "other" / "test.comp.spv", comp),
+    };
+    const std::string loose_path   = write_spirv(DIRECTORY / "shaders" / "loose.vert.spv", loose);
+    const std::string archive_path = (DIRECTORY / "shaders.pak").string();
+
+    renderer::ShaderArchive::write(archive_path, inputs);
+
+    renderer::ShaderArchive archive{};
+    assert(archive.init(archive_path));
+    assert(archive.is_open());
+    assert(archive.size() == 3);
+
+    // Shaders are found by file name, whatever directory the caller names.
+    assert(archive.find("test.vert.spv") != nullptr);
+    assert(archive.find("bin/shaders/test.frag.spv") != nullptr);
+    assert(archive.find(inputs[2]) != nullptr);
+    assert(archive.find("missing.vert.spv") == nullptr);
+    assert(archive.find("test.vert") == nullptr);
+    assert(archive.find(loose_path) == nullptr);
+
+    const renderer::ShaderArchiveEntry* entry = archive.find("test.frag.spv");
+    assert(entry->size == frag.size() * sizeof(uint32_t));
+    assert(entry->offset % renderer::ShaderArchive::CODE_ALIGNMENT == 0);
+
+    assert(same_code(archive.load("bin/shaders/test.vert.spv"), vert));
+    assert(same_code(archive.load("test.frag.spv"), frag));
+    assert(same_code(archive.load("test.comp.spv"), comp));
+
+    // Content hashes tell shaders apart, and are 0 for anything not packed.
+    uint64_t vert_hash = archive.content_hash("test.vert.spv");
+    uint64_t frag_hash = archive.content_hash("test.frag.spv");
+    assert(vert_hash != 0 && frag_hash != 0);
+    assert(vert_hash != frag_hash);
+    assert(archive.content_hash("missing.vert.spv") == 0);
+
+    // Shaders not in the archive are loaded from their file.
+    assert(same_code(archive.load(loose_path), loose));
+
+    archive.cleanup();
+    assert(!archive.is_open());
+
+    // Repacking with changed code changes the content hash, and nothing else.
+    write_spirv(DIRECTORY / "shaders" / "test.vert.spv", make_spirv(5, 5));
+    renderer::ShaderArchive::write(archive_path, inputs);
+
+    renderer::ShaderArchive repacked{};
+    assert(repacked.init(archive_path));
+    assert(repacked.content_hash("test.vert.spv") != vert_hash);
+    assert(repacked.content_hash("test.frag.spv") == frag_hash);
+    repacked.cleanup();
+}
+
+void test_missing_archive() {
+    renderer::ShaderArchive archive{};
+    assert(!archive.init((DIRECTORY / "does_not_exist.pak").string()));
+    assert(!archive.is_open());
+}
+
+void test_duplicate_names() {
+    const std::vector<std::string> inputs = {
+        write_spirv(DIRECTORY / "a" / "same.vert.spv", make_spirv(5, 6)),
+        write_spirv(DIRECTORY / "b" / "same.vert.spv", make_spirv(5, 7)),
+    };
+
+    bool threw = false;
+    try {
+        renderer::ShaderArchive::write((DIRECTORY / "duplicates.pak").string(), inputs);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+/* ---- Validation ---- */
+
+void test_rejects_damaged_archives() {
+    const std::vector<std::string> inputs = {
+        write_spirv(DIRECTORY / "shaders" / "one.vert.spv", make_spirv(8, 8)),
+        write_spirv(DIRECTORY / "shaders" / "two.frag.spv", make_spirv(12, 9)),
+        write_spirv(DIRECTORY / "shaders" / "three.comp.spv", make_spirv(16, 10)),
+    };
+    const std::string archive_path = (DIRECTORY / "valid.pak").string();
+    renderer::ShaderArchive::write(archive_path, inputs);
+
+    const std::vector<std::byte> valid = read_file(archive_path);
+
+    const size_t index_end = sizeof(renderer::ShaderArchiveHeader) + 3 * sizeof(renderer::ShaderArchiveEntry);
+
+    // Truncated anywhere: inside the header, inside the index, and by the last byte of code.
+    expect_rejected({valid.begin(), valid.begin() + 8}, "truncated header");
+    expect_rejected({valid.begin(), valid.begin() + index_end - 4}, "truncated index");
+    expect_rejected({valid.begin(), valid.end() - 1}, "code out of bounds");
+
+    std::vector<std::byte> bad_magic = valid;
+    bad_magic[0] ^= std::byte{0xff};
+    expect_rejected(bad_magic, "not a shader archive");
+
+    std::vector<std::byte> empty_index = valid;
+    reinterpret_cast<renderer::ShaderArchiveHeader*>(empty_index.data())->entry_count = 0;
+    expect_rejected(empty_index, "truncated index");
+
+    // The writer sorts by name_hash; swapping two entries breaks the binary search find() relies on.
+    std::vector<std::byte> unsorted = valid;
+    std::swap(entries(unsorted)[0], entries(unsorted)[2]);
+    expect_rejected(unsorted, "index not sorted");
+
+    std::vector<std::byte> bad_name = valid;
+    entries(bad_name)[1].name_offset = 1u << 20;
+    expect_rejected(bad_name, "name out of bounds");
+
+    std::vector<std::byte> bad_code = valid;
+    entries(bad_code)[1].offset = bad_code.size();
+    expect_rejected(bad_code, "code out of bounds");
+
+    std::vector<std::byte> overlapping_index = valid;
+    entries(overlapping_index)[1].offset = 0;
+    expect_rejected(overlapping_index, "code out of bounds");
+
+    // And the untouched bytes still load.
+    renderer::ShaderArchive archive{};
+    assert(archive.init(write_file(DIRECTORY / "copy.pak", valid)));
+    assert(archive.size() == 3);
+    archive.cleanup();
+}
+
+}  // namespace
+
+int main() {
+    std::filesystem::remove_all(DIRECTORY);
+
+    test_pack_and_find();
+    test_missing_archive();
+    test_duplicate_names();
+    test_rejects_damaged_archives();
+
+    std::filesystem::remove_all(DIRECTORY);
+
+    std::cout << "shader_archive => all tests passed\n";
+    return 0;
+}
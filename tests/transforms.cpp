@@ -0,0 +1,162 @@
+// Asserts must stay live in the release, lto and pgo configurations, which build with -DNDEBUG.
+#undef NDEBUG
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "simd.hpp"
+#include "transforms.hpp"
+
+// compute_world_matrices over TransformSoA against the array-of-structs path, with counts around the SIMD width so
+// both the vector loop and the scalar tail are covered.
+
+namespace {
+
+#if defined(MATH_SIMD_AVX2)
+constexpr size_t SIMD_WIDTH = 8;
+#elif defined(MATH_SIMD_SSE) || defined(MATH_SIMD_NEON)
+constexpr size_t SIMD_WIDTH = 4;
+#else
+constexpr size_t SIMD_WIDTH = 1;
+#endif
+
+constexpr float TOLERANCE = 1e-4f;  // translations reach 100
+
+math::Transform random_transform(std::mt19937& rng) {
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+    math::Transform transform;
+    transform.position = {100.0f * value(rng), 100.0f * value(rng), 100.0f * value(rng)};
+    transform.rotation = math::axis_angle(math::normalize(math::Vec3{value(rng), value(rng), value(rng)}), value(rng));
+    transform.scale    = {scale(rng), scale(rng), scale(rng)};
+    return transform;
+}
+
+bool near(const math::Mat4& a, const math::Mat4& b) {
+    const float* x = &a.columns[0].x;
+    const float* y = &b.columns[0].x;
+    for (int i = 0; i < 16; ++i) {
+        if (std::abs(x[i] - y[i]) > TOLERANCE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Computes count world matrices starting at first and compares them with the AoS path. The output has one guard
+// matrix on either side, which must stay untouched.
+void check_world_matrices(size_t size, size_t first, size_t count) {
+    std::mt19937 rng(static_cast<uint32_t>(size * 31 + first));
+
+    std::vector<math::Transform> aos(size);
+    math::TransformSoA           soa;
+    for (math::Transform& transform : aos) {
+        transform = random_transform(rng);
+        soa.push_back(transform);
+    }
+
+    std::vector<math::Mat4> expected(size);
+    math::compute_world_matrices(aos, expected);
+
+    math::Mat4 guard;
+    guard.columns[0].x = 42.0f;
+
+    std::vector<math::Mat4> simd(count + 2, guard);
+    std::vector<math::Mat4> scalar(count + 2, guard);
+    math::compute_world_matrices(soa, first, std::span<math::Mat4>(simd).subspan(1, count));
+    math::scalar::compute_world_matrices(soa, first, std::span<math::Mat4>(scalar).subspan(1, count));
+
+    for (size_t i = 0; i < count; ++i) {
+        assert(near(simd[i + 1], expected[first + i]));
+        assert(near(scalar[i + 1], expected[first + i]));
+    }
+
+    assert(simd.front().columns[0].x == 42.0f && simd.back().columns[0].x == 42.0f);
+    assert(scalar.front().columns[0].x == 42.0f && scalar.back().columns[0].x == 42.0f);
+}
+
+void test_counts() {
+    const size_t counts[] = {0, 1, SIMD_WIDTH - 1, SIMD_WIDTH, SIMD_WIDTH + 1, 2 * SIMD_WIDTH + 3, 1000};
+
+    for (size_t count : counts) {
+        check_world_matrices(count, 0, count);
+    }
+}
+
+void test_offsets() {
+    // A first that is not a multiple of the width makes the stream loads unaligned.
+    for (size_t first : {size_t{1}, SIMD_WIDTH - 1, SIMD_WIDTH + 1}) {
+        for (size_t count : {size_t{0}, size_t{1}, SIMD_WIDTH - 1, SIMD_WIDTH + 1}) {
+            check_world_matrices(first + count + 5, first, count);
+        }
+    }
+}
+
+void test_out_of_range() {
+    std::mt19937       rng(7);
+    math::TransformSoA soa;
+    for (size_t i = 0; i < SIMD_WIDTH + 1; ++i) {
+        soa.push_back(random_transform(rng));
+    }
+
+    // Only the transforms that exist are written; the rest of out stays as it was.
+    math::Mat4 guard;
+    guard.columns[0].x = 42.0f;
+
+    std::vector<math::Mat4> out(2 * SIMD_WIDTH + 2, guard);
+    math::compute_world_matrices(soa, 1, out);
+
+    for (size_t i = 0; i < out.size(); ++i) {
+        assert((out[i].columns[0].x == 42.0f) == (i >= SIMD_WIDTH));
+    }
+
+    std::vector<math::Mat4> past_end(4, guard);
+    math::compute_world_matrices(soa, soa.size() + 3, past_end);
+    for (const math::Mat4& m : past_end) {
+        assert(m.columns[0].x == 42.0f);
+    }
+}
+
+void test_soa_round_trip() {
+    std::mt19937       rng(11);
+    math::TransformSoA soa;
+
+    std::vector<math::Transform> aos(SIMD_WIDTH + 1);
+    for (math::Transform& transform : aos) {
+        transform = random_transform(rng);
+        soa.push_back(transform);
+    }
+
+    assert(soa.size() == aos.size());
+    assert(soa.capacity() % math::TransformSoA::FLOATS_PER_LINE == 0);
+
+    for (size_t i = 0; i < aos.size(); ++i) {
+        math::Transform transform = soa.get(i);
+        assert(transform.position.x == aos[i].position.x && transform.rotation.w == aos[i].rotation.w &&
+               transform.scale.z == aos[i].scale.z);
+    }
+
+    // New transforms are identities.
+    soa.resize(aos.size() + 2);
+    std::vector<math::Mat4> identities(2);
+    math::compute_world_matrices(soa, aos.size(), identities);
+    assert(near(identities[0], math::Mat4{}) && near(identities[1], math::Mat4{}));
+}
+
+}  // namespace
+
+int main() {
+    test_counts();
+    test_offsets();
+    test_out_of_range();
+    test_soa_round_trip();
+
+    std::cout << "transforms => all tests passed, SIMD path: " << math::simd_path() << "\n";
+    return 0;
+}
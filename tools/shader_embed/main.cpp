@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Writes compiled shaders into a C++ header of constexpr arrays, for EMBED_SHADERS=1 builds:
+//
+//   shader_embed <header.hpp> <shader.spv>...
+//
+// Only uses the standard library, since lib/embedded_shaders.cpp is compiled from its output.
+
+namespace {
+
+constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+
+class Shader {
+   public:
+    std::string           name;        // file name, what pipelines look the shader up by
+    std::string           identifier;  // name of the array
+    std::vector<uint32_t> words;
+};
+
+std::string identifier(const std::string& name) {
+    std::string result = name;
+    std::replace_if(result.begin(), result.end(), [](char c) { return !std::isalnum(static_cast<unsigned char>(c)); },
+                    '_');
+
+    return result;
+}
+
+bool read_shader(const std::string& path, Shader& shader) {
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "shader_embed => failed to open " << path << "\n";
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(file.tellg());
+    if (size == 0 || size % sizeof(uint32_t) != 0) {
+        std::cerr << "shader_embed => " << path << " is not a whole number of 32-bit words\n";
+        return false;
+    }
+
+    shader.name       = std::filesystem::path(path).filename().string();
+    shader.identifier = identifier(shader.name);
+    shader.words.resize(size / sizeof(uint32_t));
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(shader.words.data()), static_cast<std::streamsize>(size));
+
+    if (shader.words[0] != SPIRV_MAGIC) {
+        std::cerr << "shader_embed => " << path << " is not SPIR-V\n";
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <header.hpp> <shader.spv>...\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Shader> shaders(static_cast<size_t>(argc - 2));
+    for (int i = 2; i < argc; ++i) {
+        if (!read_shader(argv[i], shaders[static_cast<size_t>(i - 2)])) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Sorted by name, the runtime looks shaders up by binary search.
+    std::sort(shaders.begin(), shaders.end(), [](const Shader& a, const Shader& b) { return a.name < b.name; });
+
+    std::ostringstream header;
+    header << "// Generated by tools/shader_embed, do not edit.\n"
+           << "#pragma once\n\n"
+           << "#include <cstdint>\n"
+           << "#include <span>\n"
+           << "#include <string_view>\n\n"
+           << "namespace renderer::embedded {\n\n"
+           << "class EmbeddedShader {\n"
+           << "   public:\n"
+           << "    std::string_view          name;\n"
+           << "    std::span<const uint32_t> code;\n"
+           << "};\n\n";
+
+    header << std::hex << std::setfill('0');
+    for (const Shader& shader : shaders) {
+        header << "inline constexpr uint32_t " << shader.identifier << "[] = {";
+        for (size_t i = 0; i < shader.words.size(); ++i) {
+            header << (i % 8 == 0 ? "\n    " : " ") << "0x" << std::setw(8) << shader.words[i] << ",";
+        }
+        header << "\n};\n\n";
+    }
+
+    header << "inline constexpr EmbeddedShader SHADERS[] = {\n";
+    for (const Shader& shader : shaders) {
+        header << "    {\"" << shader.name << "\", " << shader.identifier << "},\n";
+    }
+    header << "};\n\n"
+           << "}  // namespace renderer::embedded\n";
+
+    const std::string output = argv[1];
+
+    std::ofstream file(output, std::ios::binary | std::ios::trunc);
+    file << header.str();
+    if (!file.good()) {
+        std::cerr << "shader_embed => failed to write " << output << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "shader_embed => " << shaders.size() << " shaders embedded into " << output << "\n";
+    return EXIT_SUCCESS;
+}
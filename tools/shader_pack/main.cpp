@@ -0,0 +1,43 @@
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "shader_archive.hpp"
+
+// Packs compiled shaders into the archive apps load them from:
+//
+//   shader_pack <archive> <shader.spv>...
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <archive> <shader.spv>...\n";
+        return EXIT_FAILURE;
+    }
+
+    const std::string        archive = argv[1];
+    std::vector<std::string> inputs(argv + 2, argv + argc);
+
+    try {
+        renderer::ShaderArchive::write(archive, inputs);
+
+        // Read it back the way apps do, so a bad archive fails the build instead of the first launch.
+        renderer::ShaderArchive reader{};
+        reader.init(archive);
+        for (const std::string& input : inputs) {
+            if (reader.find(input) == nullptr) {
+                std::cerr << "shader_pack => " << input << " is missing from " << archive << "\n";
+                return EXIT_FAILURE;
+            }
+            reader.load(input);
+        }
+
+        std::cout << "shader_pack => " << reader.size() << " shaders packed into " << archive << "\n";
+        reader.cleanup();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}